@@ -0,0 +1,392 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "binary_game_msg.hpp"
+
+#include <cassert>
+#include <stdexcept>
+#include "hexagon_index.hpp"
+#include "hexagon_tables.hpp"
+
+using namespace std;
+using namespace cyvmath;
+using namespace cyvmath::mikelepage;
+using namespace cyvws;
+
+namespace binary
+{
+	using gamemsg::Action;
+	using gamemsg::actionCount;
+
+	typedef HexagonIndex<6> Index;
+	typedef HexagonTables<6> Tables;
+
+	static uint8_t s_encodingVersion = VERSION;
+
+	void setEncodingVersion(uint8_t version)
+	{
+		assert(version > 0 && version <= VERSION);
+		s_encodingVersion = version;
+	}
+
+	static string header(uint8_t actionId, size_t paramSize, uint8_t version = s_encodingVersion)
+	{
+		string ret;
+		ret.reserve(headerSize + paramSize);
+
+		ret.push_back(static_cast<char>(MAGIC));
+		ret.push_back(static_cast<char>(version));
+		ret.push_back(static_cast<char>(actionId));
+
+		return ret;
+	}
+
+	static string header(Action action, size_t paramSize)
+	{
+		return header(static_cast<uint8_t>(action), paramSize);
+	}
+
+	static void writePieceType(string& data, PieceType type)
+	{
+		data.push_back(static_cast<char>(type));
+	}
+
+	static void writeCoord(string& data, const Coordinate& coord)
+	{
+		data.push_back(static_cast<char>(Index::index(coord)));
+	}
+
+	static void writeTime(string& data, uint64_t time)
+	{
+		for(int i = 0; i < 8; i++)
+			data.push_back(static_cast<char>((time >> (i * 8)) & 0xFF));
+	}
+
+	static void writeSeq(string& data, uint32_t seq)
+	{
+		for(int i = 0; i < 4; i++)
+			data.push_back(static_cast<char>((seq >> (i * 8)) & 0xFF));
+	}
+
+	static uint8_t readByte(const string& data, size_t pos)
+	{
+		if(pos >= data.size())
+			throw runtime_error("binary game message is too short");
+
+		return static_cast<uint8_t>(data[pos]);
+	}
+
+	static PieceType readPieceType(const string& data, size_t pos)
+	{
+		uint8_t val = readByte(data, pos);
+		if(val > static_cast<uint8_t>(PieceType::KING))
+			throw runtime_error("invalid piece type " + to_string(val) + " in binary game message");
+
+		return static_cast<PieceType>(val);
+	}
+
+	static Hexagon<6>::Coordinate readCoord(const string& data, size_t pos)
+	{
+		uint8_t val = readByte(data, pos);
+		if(val >= Index::tileCount)
+			throw runtime_error("invalid tile index " + to_string(val) + " in binary game message");
+
+		return Tables::coordinate(val);
+	}
+
+	static void checkAction(const string& data, Action expected)
+	{
+		if(action(data) != expected)
+			throw runtime_error("binary game message has an unexpected action");
+	}
+
+	string gameMsgHello()
+	{
+		return header(HELLO, 0, VERSION);
+	}
+
+	string gameMsgPing(uint64_t time)
+	{
+		string ret = header(PING, 8);
+		writeTime(ret, time);
+
+		return ret;
+	}
+
+	string gameMsgPong(uint64_t pingTime, uint64_t receiveTime, uint64_t time)
+	{
+		string ret = header(PONG, 24);
+		writeTime(ret, pingTime);
+		writeTime(ret, receiveTime);
+		writeTime(ret, time);
+
+		return ret;
+	}
+
+	string gameMsgTimestamp(uint64_t time)
+	{
+		string ret = header(TIMESTAMP, 8);
+		writeTime(ret, time);
+
+		return ret;
+	}
+
+	string gameMsgAck(uint32_t seq)
+	{
+		string ret = header(ACK, 4);
+		writeSeq(ret, seq);
+
+		return ret;
+	}
+
+	string gameMsgReject(uint32_t seq)
+	{
+		string ret = header(REJECT, 4);
+		writeSeq(ret, seq);
+
+		return ret;
+	}
+
+	string gameMsgSeq(uint32_t seq)
+	{
+		string ret = header(SEQ, 4);
+		writeSeq(ret, seq);
+
+		return ret;
+	}
+
+	string gameMsgResync(uint32_t receivedSeq, uint32_t sentSeq)
+	{
+		string ret = header(RESYNC, 8);
+		writeSeq(ret, receivedSeq);
+		writeSeq(ret, sentSeq);
+
+		return ret;
+	}
+
+	string gameMsgSetOpeningArray(const ActivePieceMap& pieces)
+	{
+		assert(pieces.size() <= UINT8_MAX);
+
+		string ret = header(Action::SET_OPENING_ARRAY, 1 + pieces.size() * 2);
+		ret.push_back(static_cast<char>(pieces.size()));
+
+		for(const auto& it : pieces)
+		{
+			writePieceType(ret, it.second->getType());
+			writeCoord(ret, it.first);
+		}
+
+		return ret;
+	}
+
+	string gameMsgSetIsReady()
+	{
+		return header(Action::SET_IS_READY, 0);
+	}
+
+	string gameMsgMove(PieceType type, Coordinate oldPos, Coordinate newPos)
+	{
+		string ret = header(Action::MOVE, 3);
+		writePieceType(ret, type);
+		writeCoord(ret, oldPos);
+		writeCoord(ret, newPos);
+
+		return ret;
+	}
+
+	string gameMsgMoveCapture(PieceType atkPT, Coordinate oldPos, Coordinate newPos, PieceType defPT, Coordinate defPiecePos)
+	{
+		string ret = header(Action::MOVE_CAPTURE, 5);
+		writePieceType(ret, atkPT);
+		writeCoord(ret, oldPos);
+		writeCoord(ret, newPos);
+		writePieceType(ret, defPT);
+		writeCoord(ret, defPiecePos);
+
+		return ret;
+	}
+
+	string gameMsgPromote(PieceType origType, PieceType newType)
+	{
+		string ret = header(Action::PROMOTE, 2);
+		writePieceType(ret, origType);
+		writePieceType(ret, newType);
+
+		return ret;
+	}
+
+	string gameMsgResign()
+	{
+		return header(Action::RESIGN, 0);
+	}
+
+	void appendToBatch(string& batch, const string& msg)
+	{
+		assert(msg.size() <= UINT16_MAX);
+
+		if(batch.empty())
+			batch = header(BATCH, 2 + msg.size());
+
+		batch.push_back(static_cast<char>(msg.size() & 0xFF));
+		batch.push_back(static_cast<char>(msg.size() >> 8));
+		batch.append(msg);
+	}
+
+	bool isGameMsg(const string& data)
+	{
+		return data.size() >= headerSize && static_cast<uint8_t>(data[0]) == MAGIC;
+	}
+
+	uint8_t version(const string& data)
+	{
+		if(!isGameMsg(data))
+			throw runtime_error("not a binary game message");
+
+		return static_cast<uint8_t>(data[1]);
+	}
+
+	uint8_t actionId(const string& data)
+	{
+		if(!isGameMsg(data))
+			throw runtime_error("not a binary game message");
+
+		return static_cast<uint8_t>(data[2]);
+	}
+
+	bool isHello(const string& data)
+	{
+		return isGameMsg(data) && static_cast<uint8_t>(data[2]) == HELLO;
+	}
+
+	bool isBatch(const string& data)
+	{
+		return isGameMsg(data) && static_cast<uint8_t>(data[2]) == BATCH;
+	}
+
+	vector<string> batchMessages(const string& data)
+	{
+		if(!isBatch(data))
+			throw runtime_error("not a binary message batch");
+
+		vector<string> ret;
+
+		size_t pos = headerSize;
+		while(pos < data.size())
+		{
+			size_t size = readByte(data, pos) | (readByte(data, pos + 1) << 8);
+			pos += 2;
+
+			if(data.size() - pos < size)
+				throw runtime_error("binary message batch is too short");
+
+			ret.push_back(data.substr(pos, size));
+			pos += size;
+		}
+
+		return ret;
+	}
+
+	Action action(const string& data)
+	{
+		if(!isGameMsg(data))
+			throw runtime_error("not a binary game message");
+
+		uint8_t val = static_cast<uint8_t>(data[2]);
+		if(val >= actionCount)
+			throw runtime_error("unknown action " + to_string(val) + " in binary game message");
+
+		return static_cast<Action>(val);
+	}
+
+	uint64_t time(const string& data, size_t n)
+	{
+		uint8_t id = actionId(data);
+		if(id != PING && id != PONG && id != TIMESTAMP)
+			throw runtime_error("binary message doesn't contain a time");
+
+		uint64_t ret = 0;
+		for(size_t i = 0; i < 8; i++)
+			ret |= static_cast<uint64_t>(readByte(data, headerSize + n * 8 + i)) << (i * 8);
+
+		return ret;
+	}
+
+	uint32_t seq(const string& data, size_t n)
+	{
+		uint8_t id = actionId(data);
+		if(id != ACK && id != REJECT && id != SEQ && id != RESYNC)
+			throw runtime_error("binary message doesn't contain a sequence number");
+
+		uint32_t ret = 0;
+		for(size_t i = 0; i < 4; i++)
+			ret |= static_cast<uint32_t>(readByte(data, headerSize + n * 4 + i)) << (i * 8);
+
+		return ret;
+	}
+
+	PieceMap pieceMap(const string& data)
+	{
+		checkAction(data, Action::SET_OPENING_ARRAY);
+
+		PieceMap ret;
+
+		size_t count = readByte(data, headerSize);
+		for(size_t i = 0; i < count; i++)
+		{
+			size_t pos = headerSize + 1 + i * 2;
+
+			auto& coords = ret[readPieceType(data, pos)];
+			coords.insert(coords.end(), readCoord(data, pos + 1));
+		}
+
+		return ret;
+	}
+
+	Movement movement(const string& data)
+	{
+		checkAction(data, Action::MOVE);
+
+		return {
+			readPieceType(data, headerSize),
+			readCoord(data, headerSize + 1),
+			readCoord(data, headerSize + 2)
+		};
+	}
+
+	MoveCapture moveCapture(const string& data)
+	{
+		checkAction(data, Action::MOVE_CAPTURE);
+
+		return {
+			readPieceType(data, headerSize),
+			readCoord(data, headerSize + 1),
+			readCoord(data, headerSize + 2),
+			readPieceType(data, headerSize + 3),
+			readCoord(data, headerSize + 4)
+		};
+	}
+
+	Promotion promotion(const string& data)
+	{
+		checkAction(data, Action::PROMOTE);
+
+		return {
+			readPieceType(data, headerSize),
+			readPieceType(data, headerSize + 1)
+		};
+	}
+}
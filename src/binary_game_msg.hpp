@@ -0,0 +1,109 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _BINARY_GAME_MSG_HPP_
+#define _BINARY_GAME_MSG_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <cyvmath/piece_type.hpp>
+#include <cyvmath/mikelepage/match.hpp>
+#include <cyvmath/mikelepage/player.hpp>
+#include <cyvws/game_msg.hpp>
+#include "game_msg.hpp"
+
+/* Compact binary encoding of the game messages, as an alternative to
+ * the JSON encoding in cyvws::json. Every message starts with a three
+ * byte header (magic byte, protocol version, action id), followed by the
+ * parameters of the action. The action ids are the gamemsg::Action
+ * values. Piece types are one byte each, coordinates are sent as their
+ * one byte HexagonIndex.
+ *
+ * A client may only send binary messages after the remote end announced
+ * that it understands them by sending a HELLO message.
+ */
+namespace binary
+{
+	const uint8_t MAGIC   = 0xCB;
+	const uint8_t VERSION = 1;
+
+	const std::size_t headerSize = 3;
+
+	// action ids of messages which aren't game actions
+	const uint8_t HELLO     = 0xFF;
+	const uint8_t BATCH     = 0xFE; // contains multiple messages
+	const uint8_t PING      = 0xFD; // send time
+	const uint8_t PONG      = 0xFC; // send time of the ping, receive time of the ping, send time
+	const uint8_t TIMESTAMP = 0xFB; // time of the input that caused the following messages
+	const uint8_t ACK       = 0xFA; // sequence number of the last game message handled
+	const uint8_t REJECT    = 0xF9; // sequence number of a game message that was invalid
+	const uint8_t SEQ       = 0xF8; // sequence number of the next game message in the batch
+	const uint8_t RESYNC    = 0xF7; // sequence numbers of the last game message received and sent
+
+	// all times are 8 byte little endian values, in milliseconds since the epoch
+
+	// the version written into all messages except HELLO, which always
+	// announces VERSION. Set to the version both ends understand once
+	// the HELLO of the remote end was received.
+	void setEncodingVersion(uint8_t version);
+
+	std::string gameMsgHello();
+	std::string gameMsgPing(uint64_t time);
+	std::string gameMsgPong(uint64_t pingTime, uint64_t receiveTime, uint64_t time);
+	std::string gameMsgTimestamp(uint64_t time);
+	std::string gameMsgAck(uint32_t seq);
+	std::string gameMsgReject(uint32_t seq);
+	std::string gameMsgSeq(uint32_t seq);
+	std::string gameMsgResync(uint32_t receivedSeq, uint32_t sentSeq);
+	std::string gameMsgSetOpeningArray(const cyvmath::mikelepage::ActivePieceMap&);
+	std::string gameMsgSetIsReady();
+	std::string gameMsgMove(cyvmath::PieceType, cyvmath::Coordinate oldPos, cyvmath::Coordinate newPos);
+	std::string gameMsgMoveCapture(cyvmath::PieceType atkPT, cyvmath::Coordinate oldPos, cyvmath::Coordinate newPos,
+		cyvmath::PieceType defPT, cyvmath::Coordinate defPiecePos);
+	std::string gameMsgPromote(cyvmath::PieceType origType, cyvmath::PieceType newType);
+	std::string gameMsgResign();
+
+	// appends msg to the BATCH message batch, which is started if it's empty.
+	// Inside of a batch, every message is preceded by its length (2 bytes).
+	void appendToBatch(std::string& batch, const std::string& msg);
+
+	// whether data starts with a valid message header
+	bool isGameMsg(const std::string& data);
+
+	// these throw a std::runtime_error if the message is malformed
+	uint8_t version(const std::string& data);
+	uint8_t actionId(const std::string& data);
+	bool isHello(const std::string& data);
+	bool isBatch(const std::string& data);
+	// returns the messages contained in the BATCH message data
+	std::vector<std::string> batchMessages(const std::string& data);
+	gamemsg::Action action(const std::string& data);
+
+	// returns the n-th time value of a PING, PONG or TIMESTAMP message
+	uint64_t time(const std::string& data, std::size_t n = 0);
+
+	// returns the n-th sequence number of an ACK, REJECT, SEQ or RESYNC message
+	uint32_t seq(const std::string& data, std::size_t n = 0);
+
+	cyvmath::mikelepage::PieceMap pieceMap(const std::string& data);
+	cyvws::Movement movement(const std::string& data);
+	cyvws::MoveCapture moveCapture(const std::string& data);
+	cyvws::Promotion promotion(const std::string& data);
+}
+
+#endif // _BINARY_GAME_MSG_HPP_
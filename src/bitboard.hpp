@@ -0,0 +1,167 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _BITBOARD_HPP_
+#define _BITBOARD_HPP_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+/* A set of up to 128 tiles, one bit per tile index as defined by
+ * HexagonIndex, which is enough for hexagons with an edge length of
+ * up to 7. Set operations are done on two 64 bit words, so they
+ * compile to a handful of instructions on every platform, including
+ * emscripten, which has no native 128 bit type.
+ */
+class Bitboard
+{
+	private:
+		uint64_t m_lo, m_hi;
+
+		static int popcount(uint64_t v)
+		{ return __builtin_popcountll(v); }
+
+		static int ctz(uint64_t v)
+		{ return __builtin_ctzll(v); }
+
+		static int clz(uint64_t v)
+		{ return __builtin_clzll(v); }
+
+	public:
+		static constexpr std::size_t size = 128;
+
+		constexpr Bitboard()
+			: m_lo(0)
+			, m_hi(0)
+		{ }
+
+		constexpr Bitboard(uint64_t lo, uint64_t hi)
+			: m_lo(lo)
+			, m_hi(hi)
+		{ }
+
+		static constexpr Bitboard bit(std::size_t index)
+		{
+			return index < 64
+				? Bitboard(uint64_t(1) << index, 0)
+				: Bitboard(0, uint64_t(1) << (index - 64));
+		}
+
+		// the first count bits set
+		static constexpr Bitboard range(std::size_t count)
+		{
+			return count <= 64
+				? Bitboard(count == 64 ? ~uint64_t(0) : (uint64_t(1) << count) - 1, 0)
+				: Bitboard(~uint64_t(0), count == 128 ? ~uint64_t(0) : (uint64_t(1) << (count - 64)) - 1);
+		}
+
+		constexpr bool test(std::size_t index) const
+		{
+			return index < 64
+				? (m_lo >> index) & 1
+				: (m_hi >> (index - 64)) & 1;
+		}
+
+		constexpr void set(std::size_t index)
+		{
+			assert(index < size);
+			*this |= bit(index);
+		}
+
+		constexpr void reset(std::size_t index)
+		{
+			assert(index < size);
+			*this &= ~bit(index);
+		}
+
+		constexpr bool any() const
+		{ return m_lo || m_hi; }
+
+		constexpr bool none() const
+		{ return !any(); }
+
+		int count() const
+		{ return popcount(m_lo) + popcount(m_hi); }
+
+		// index of the lowest set bit, there has to be one
+		std::size_t first() const
+		{
+			assert(any());
+			return m_lo ? ctz(m_lo) : 64 + ctz(m_hi);
+		}
+
+		// index of the highest set bit, there has to be one
+		std::size_t last() const
+		{
+			assert(any());
+			return m_hi ? 127 - clz(m_hi) : 63 - clz(m_lo);
+		}
+
+		// clears the lowest set bit and returns its index
+		std::size_t popFirst()
+		{
+			std::size_t index = first();
+
+			if(m_lo)
+				m_lo &= m_lo - 1;
+			else
+				m_hi &= m_hi - 1;
+
+			return index;
+		}
+
+		// calls func with the index of every set bit, in ascending order
+		template<class Func>
+		void forEach(Func func) const
+		{
+			Bitboard tmp = *this;
+			while(tmp.any())
+				func(tmp.popFirst());
+		}
+
+		constexpr Bitboard operator&(const Bitboard& o) const
+		{ return Bitboard(m_lo & o.m_lo, m_hi & o.m_hi); }
+
+		constexpr Bitboard operator|(const Bitboard& o) const
+		{ return Bitboard(m_lo | o.m_lo, m_hi | o.m_hi); }
+
+		constexpr Bitboard operator^(const Bitboard& o) const
+		{ return Bitboard(m_lo ^ o.m_lo, m_hi ^ o.m_hi); }
+
+		constexpr Bitboard operator~() const
+		{ return Bitboard(~m_lo, ~m_hi); }
+
+		constexpr Bitboard& operator&=(const Bitboard& o)
+		{ m_lo &= o.m_lo; m_hi &= o.m_hi; return *this; }
+
+		constexpr Bitboard& operator|=(const Bitboard& o)
+		{ m_lo |= o.m_lo; m_hi |= o.m_hi; return *this; }
+
+		constexpr Bitboard& operator^=(const Bitboard& o)
+		{ m_lo ^= o.m_lo; m_hi ^= o.m_hi; return *this; }
+
+		constexpr bool operator==(const Bitboard& o) const
+		{ return m_lo == o.m_lo && m_hi == o.m_hi; }
+
+		constexpr bool operator!=(const Bitboard& o) const
+		{ return !(*this == o); }
+};
+
+static_assert(Bitboard::range(91).test(90) && !Bitboard::range(91).test(91), "");
+static_assert(Bitboard::bit(64) == Bitboard(0, 1), "");
+
+#endif // _BITBOARD_HPP_
@@ -16,14 +16,22 @@
 
 #include "cyvasse_app.hpp"
 
+#include <array>
+#include <chrono>
+#include <cstdlib>
 #include <map>
 #include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include <fea/ui/sdlwindowbackend.hpp>
 #include <fea/ui/sdlinputbackend.hpp>
 
 #include <cyvmath/rule_sets.hpp>
+#include "cyvasse_ws_client.hpp"
 #include "ingame_state.hpp"
+#include "texture_atlas.hpp"
 
 #ifdef __EMSCRIPTEN__
 	#include <emscripten.h>
@@ -33,7 +41,32 @@
 
 using namespace cyvmath;
 
-void CyvasseApp::setup(const std::vector<std::string>& /* args */)
+static vector<string> getAtlasImagePaths()
+{
+	static const array<string, 12> pieceIcons {{
+		"mountains", "rabble", "crossbows", "spears", "light_horse", "trebuchet",
+		"elephant", "heavy_horse", "dragon", "king", "fortress", "fortress_ruined"
+	}};
+
+	static const array<string, 4> terrainIcons {{
+		"hill", "forest", "grassland", "mountains"
+	}};
+
+	vector<string> ret;
+
+	for(PlayersColor color : {PlayersColor::WHITE, PlayersColor::BLACK})
+		for(const auto& name : pieceIcons)
+			ret.push_back("res/icons/" + string(PlayersColorToStr(color)) + "/" + name + ".png");
+
+	for(const auto& name : terrainIcons)
+		ret.push_back("res/icons/" + name + ".png");
+
+	ret.push_back("res/setup-done.png");
+
+	return ret;
+}
+
+void CyvasseApp::setup(const std::vector<std::string>& args)
 {
 	static map<RuleSet, function<unique_ptr<Match>(IngameState&, fea::Renderer2D&, PlayersColor)>>
 		createMatch {{
@@ -46,7 +79,11 @@ void CyvasseApp::setup(const std::vector<std::string>& /* args */)
 
 	m_renderer.setup();
 
+	// load all textures at once, before any match is created
+	TextureAtlas::instance().build(getAtlasImagePaths());
+
 	auto ingameState = make_unique<IngameState>(m_input, m_renderer);
+	m_ingameState = ingameState.get();
 
 	#ifdef __EMSCRIPTEN__
 	EM_ASM(
@@ -57,10 +94,20 @@ void CyvasseApp::setup(const std::vector<std::string>& /* args */)
 
 	auto ruleSet = StrToRuleSet(emscripten_run_script_string("gameMetaData.ruleSet"));
 	auto color   = StrToPlayersColor(emscripten_run_script_string("gameMetaData.color"));
+
+	if(emscripten_run_script_int("gameMetaData.logLatency === true"))
+		CyvasseWSClient::instance().setLatencyLogging(true);
 	#else
 	// --- hardcoded only until game init code is written ---
 	auto ruleSet = RuleSet::MIKELEPAGE;
 	auto color = PlayersColor::WHITE;
+
+	if(std::getenv("CYVASSE_LOG_LATENCY"))
+		CyvasseWSClient::instance().setLatencyLogging(true);
+
+	// the server to play on is given as the first command line argument
+	if(args.size() > 1)
+		CyvasseWSClient::instance().connect(args[1]);
 	#endif
 
 	m_match = createMatch[ruleSet](*ingameState, m_renderer, color);
@@ -79,8 +126,26 @@ void CyvasseApp::loop()
 	// let the state machine run the current game state
 	m_stateMachine.run();
 
-	// display whatever the current game state rendered
-	m_window.swapBuffers();
+	// send everything the game state produced in one go
+	CyvasseWSClient::instance().flush();
+
+	if(m_ingameState->frameRendered())
+	{
+		// display whatever the current game state rendered
+		m_window.swapBuffers();
+		CyvasseWSClient::instance().frameRendered();
+	}
+	else
+	{
+		#ifndef __EMSCRIPTEN__
+		// nothing was rendered, so the frame rate limit of swapBuffers()
+		// doesn't apply. Input can only be polled, so wait for one
+		// frame's duration before checking for new input again.
+		std::this_thread::sleep_for(std::chrono::milliseconds(1000 / 60));
+		#endif
+		// in the browser, the main loop is driven by requestAnimationFrame
+		// and the canvas keeps its content if nothing is drawn
+	}
 
 	// exit the program when the state machine is finished
 	if(m_stateMachine.isFinished())
@@ -89,6 +154,10 @@ void CyvasseApp::loop()
 
 void CyvasseApp::destroy()
 {
+	// the texture has to be freed before the OpenGL context is gone,
+	// the static atlas instance would live longer than it
+	TextureAtlas::instance().release();
+
 	m_window.close();
 }
 
@@ -96,5 +165,6 @@ CyvasseApp::CyvasseApp()
 	: m_window(new fea::SDLWindowBackend())
 	, m_input(new fea::SDLInputBackend())
 	, m_renderer(fea::Viewport({800, 600}, {0, 0}, fea::Camera({800.0f / 2.0f, 600.0f / 2.0f})))
+	, m_ingameState(nullptr)
 {
 }
@@ -26,6 +26,8 @@
 #include <fea/ui/windowbackend.hpp>
 #include <cyvmath/match.hpp>
 
+class IngameState;
+
 class CyvasseApp : public fea::Application
 {
 	private:
@@ -36,6 +38,9 @@ class CyvasseApp : public fea::Application
 
 		std::unique_ptr<cyvmath::Match> m_match;
 
+		// owned by m_stateMachine
+		IngameState* m_ingameState;
+
 	protected:
 		void setup(const std::vector<std::string>& args) override;
 		void loop() override;
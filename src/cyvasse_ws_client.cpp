@@ -16,10 +16,11 @@
 
 #include "cyvasse_ws_client.hpp"
 
+#include <algorithm>
 #include <iostream>
 #include <cassert>
-#include <json/reader.h>
-#include <json/writer.h>
+#include <stdexcept>
+#include "binary_game_msg.hpp"
 #ifdef __EMSCRIPTEN__
 	#include "websocket_impl_emscripten.hpp"
 #else
@@ -30,13 +31,20 @@ CyvasseWSClient* CyvasseWSClient::s_instance = new CyvasseWSClient();
 
 void CyvasseWSClient::handleMessageWrap(const std::string& msg)
 {
-	if(instance().handleMessage) // if std::function object holds a callable
+	handleMessageWrap(msg.data(), msg.size());
+}
+
+void CyvasseWSClient::handleMessageWrap(const char* data, std::size_t size)
+{
+	if(handleMessage) // if std::function object holds a callable
 	{
 		try
 		{
+			// parsing the raw character range directly saves
+			// the reader from making a copy of the document
 			Json::Value val;
-			if((Json::Reader()).parse(msg, val, false))
-				CyvasseWSClient::instance().handleMessage(val);
+			if(m_jsonReader.parse(data, data + size, val, false))
+				handleMessage(val);
 		}
 		catch(std::exception& e)
 		{
@@ -45,9 +53,137 @@ void CyvasseWSClient::handleMessageWrap(const std::string& msg)
 	}
 }
 
+void CyvasseWSClient::handleBinaryMessageWrap(const char* data, std::size_t size)
+{
+	// binary messages are small enough for the
+	// short string optimization in most cases
+	handleBinaryMessageWrap(std::string(data, size));
+}
+
+void CyvasseWSClient::handleBinaryMessageWrap(const std::string& msg)
+{
+	try
+	{
+		if(!binary::isGameMsg(msg))
+			throw std::runtime_error("got a binary message in an unknown format");
+
+		// a HELLO of a newer remote end is fine, both
+		// ends then use the older version of the two
+		if(binary::actionId(msg) == binary::HELLO)
+		{
+			if(binary::version(msg) == 0)
+				throw std::runtime_error("got a HELLO message with the invalid version 0");
+
+			bool firstHello = (m_remoteBinaryVersion == 0);
+			m_remoteBinaryVersion = std::min(binary::version(msg), binary::VERSION);
+			binary::setEncodingVersion(m_remoteBinaryVersion);
+
+			// our own HELLO may have been sent before the remote
+			// end was connected, so answer the first one it sends
+			if(firstHello)
+				sendHello();
+			return;
+		}
+
+		if(binary::version(msg) > binary::VERSION)
+			throw std::runtime_error("got a binary message with the unsupported version "
+				+ std::to_string(binary::version(msg)));
+
+		uint64_t receiveTime = netTime();
+
+		switch(binary::actionId(msg))
+		{
+			case binary::BATCH:
+				for(const auto& batchedMsg : binary::batchMessages(msg))
+					handleBinaryMessageWrap(batchedMsg);
+
+				m_nextIncomingSeq = 0;
+				break;
+			case binary::PING:
+				sendBinaryNow(binary::gameMsgPong(binary::time(msg), receiveTime, netTime()));
+				break;
+			case binary::PONG:
+				m_netStats.addPing(binary::time(msg, 0), binary::time(msg, 1), binary::time(msg, 2), receiveTime);
+				break;
+			case binary::TIMESTAMP:
+				// the latency is added once the result is visible
+				m_remoteInputTime = binary::time(msg);
+				break;
+			case binary::ACK:
+				dropConfirmed(binary::seq(msg));
+				if(onAck) onAck(binary::seq(msg));
+				break;
+			case binary::REJECT:
+				// rejected messages aren't sent again
+				dropConfirmed(binary::seq(msg));
+				if(onReject) onReject(binary::seq(msg));
+				break;
+			case binary::SEQ:
+				m_nextIncomingSeq = binary::seq(msg);
+
+				// the answer to a RESYNC, nothing is missing anymore
+				if(m_nextIncomingSeq <= m_lastIncomingSeq + 1)
+					m_resyncTime = 0;
+				break;
+			case binary::RESYNC:
+				resend(binary::seq(msg, 0));
+
+				// some of the messages the remote end sent didn't arrive
+				if(binary::seq(msg, 1) > m_lastIncomingSeq && m_resyncTime == 0)
+					requestResync();
+				break;
+			default:
+			{
+				uint32_t seq = m_nextIncomingSeq ? m_nextIncomingSeq++ : m_lastIncomingSeq + 1;
+
+				// already handled before a reconnect
+				if(seq <= m_lastIncomingSeq)
+					break;
+
+				if(seq > m_lastIncomingSeq + 1)
+				{
+					// messages got lost, ask for them and drop
+					// everything until they arrive. flush()
+					// asks again if the RESYNC isn't answered.
+					if(m_resyncTime == 0)
+						requestResync();
+					break;
+				}
+
+				m_lastIncomingSeq = seq;
+				m_resyncTime = 0;
+
+				if(handleBinaryMessage)
+					handleBinaryMessage(msg, seq);
+			}
+		}
+	}
+	catch(std::exception& e)
+	{
+		std::cerr << "Caught a std::exception while processing a remote message: " << e.what() << '\n';
+	}
+}
+
 CyvasseWSClient::CyvasseWSClient()
 	: wsImpl(new WebsocketImpl())
-{ }
+	, m_remoteBinaryVersion(0)
+	, m_binaryEnabled(true)
+	, m_binaryBatchCount(0)
+	, m_lastPingTime(0)
+	, m_latencyLogging(false)
+	, m_inputTime(0)
+	, m_remoteInputTime(0)
+	, m_gameMsgSeq(0)
+	, m_batchHasSeq(false)
+	, m_lastIncomingSeq(0)
+	, m_nextIncomingSeq(0)
+	, m_resyncTime(0)
+{
+	Json::StreamWriterBuilder builder;
+	builder["indentation"] = ""; // compact, like Json::FastWriter
+
+	m_jsonWriter.reset(builder.newStreamWriter());
+}
 
 CyvasseWSClient::~CyvasseWSClient()
 {
@@ -60,12 +196,164 @@ CyvasseWSClient& CyvasseWSClient::instance()
 	return *s_instance;
 }
 
+void CyvasseWSClient::connect(const std::string& uri)
+{
+	wsImpl->connect(uri);
+}
+
+void CyvasseWSClient::poll()
+{
+	wsImpl->poll();
+}
+
+void CyvasseWSClient::sendHello()
+{
+	// the remote end may not understand batches yet,
+	// so send the HELLO message on its own
+	flush();
+	sendBinaryNow(binary::gameMsgHello());
+}
+
 void CyvasseWSClient::send(const std::string& str)
 {
-	wsImpl->send(str);
+	send(str.data(), str.size());
+}
+
+void CyvasseWSClient::send(const char* data, std::size_t size)
+{
+	// keep the order of the messages
+	flush();
+	wsImpl->send(data, size);
 }
 
 void CyvasseWSClient::send(const Json::Value& val)
 {
-	send((Json::FastWriter()).write(val));
+	// resetting the stream keeps the writer and the stream
+	// buffer around, only str() makes a copy of the message
+	m_sendStream.str(std::string());
+	m_sendStream.clear();
+	m_jsonWriter->write(val, &m_sendStream);
+
+	send(m_sendStream.str());
+}
+
+void CyvasseWSClient::sendBinary(const std::string& data)
+{
+	binary::appendToBatch(m_binaryBatch, data);
+	m_binaryBatchCount++;
+}
+
+void CyvasseWSClient::sendBinaryNow(const std::string& data)
+{
+	wsImpl->sendBinary(data.data(), data.size());
+}
+
+uint32_t CyvasseWSClient::sendGameMsg(const Json::Value& val, const std::string& binaryMsg)
+{
+	send(val);
+
+	uint32_t seq = ++m_gameMsgSeq;
+	m_unconfirmed.emplace_back(seq, binaryMsg);
+
+	return seq;
+}
+
+uint32_t CyvasseWSClient::sendBinaryGameMsg(const std::string& data)
+{
+	uint32_t seq = ++m_gameMsgSeq;
+
+	// the game messages of one batch are consecutive,
+	// so only the first sequence number is sent
+	if(!m_batchHasSeq)
+	{
+		if(m_latencyLogging && m_inputTime != 0)
+			sendBinary(binary::gameMsgTimestamp(m_inputTime));
+
+		sendBinary(binary::gameMsgSeq(seq));
+		m_batchHasSeq = true;
+	}
+
+	sendBinary(data);
+	m_unconfirmed.emplace_back(seq, data);
+
+	return seq;
+}
+
+void CyvasseWSClient::dropConfirmed(uint32_t seq)
+{
+	while(!m_unconfirmed.empty() && m_unconfirmed.front().first <= seq)
+		m_unconfirmed.pop_front();
+}
+
+void CyvasseWSClient::resend(uint32_t seq)
+{
+	// the remote end received everything up to seq
+	dropConfirmed(seq);
+
+	// the resent messages need their own batch
+	flush();
+
+	// the unconfirmed messages are consecutive and end with the last one sent
+	sendBinary(binary::gameMsgSeq(m_unconfirmed.empty() ? m_gameMsgSeq + 1 : m_unconfirmed.front().first));
+	for(const auto& it : m_unconfirmed)
+		sendBinary(it.second);
+
+	flush();
+}
+
+void CyvasseWSClient::requestResync()
+{
+	sendBinaryNow(binary::gameMsgResync(m_lastIncomingSeq, m_gameMsgSeq));
+	m_resyncTime = netTime();
+}
+
+void CyvasseWSClient::onReconnected()
+{
+	// remote ends that don't know the binary format
+	// don't know about sequence numbers either
+	if(!useBinary())
+		return;
+
+	flush();
+	requestResync();
+}
+
+void CyvasseWSClient::flush()
+{
+	uint64_t now = netTime();
+
+	if(m_binaryBatchCount == 1)
+	{
+		// no need for the batch envelope, skip it and the length
+		const std::size_t offset = binary::headerSize + 2;
+		wsImpl->sendBinary(m_binaryBatch.data() + offset, m_binaryBatch.size() - offset);
+	}
+	else if(m_binaryBatchCount > 1)
+		wsImpl->sendBinary(m_binaryBatch.data(), m_binaryBatch.size());
+
+	m_binaryBatch.clear();
+	m_binaryBatchCount = 0;
+	m_batchHasSeq = false;
+	m_inputTime = 0;
+
+	if(m_resyncTime != 0 && now - m_resyncTime >= resyncInterval)
+		requestResync();
+
+	if(useBinary() && now - m_lastPingTime >= pingInterval)
+	{
+		sendBinaryNow(binary::gameMsgPing(now));
+		m_lastPingTime = now;
+	}
+}
+
+void CyvasseWSClient::frameRendered()
+{
+	if(m_remoteInputTime == 0)
+		return;
+
+	int32_t latency = m_netStats.addMessage(m_remoteInputTime, netTime());
+	m_remoteInputTime = 0;
+
+	if(m_latencyLogging && latency >= 0)
+		std::cout << "Latency from the remote click to rendering: " << latency << " ms\n";
 }
@@ -17,8 +17,18 @@
 #ifndef _CYVASSE_WS_CLIENT_HPP_
 #define _CYVASSE_WS_CLIENT_HPP_
 
+#include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <functional>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <json/reader.h>
 #include <json/value.h>
+#include <json/writer.h>
+#include "net_stats.hpp"
 
 class WebsocketImpl;
 
@@ -27,6 +37,63 @@ class CyvasseWSClient
 	private:
 		WebsocketImpl* wsImpl;
 
+		// reused for all incoming messages
+		Json::Reader m_jsonReader;
+
+		// binary protocol version announced by the remote end,
+		// 0 if it didn't announce to understand binary messages
+		uint8_t m_remoteBinaryVersion;
+		bool m_binaryEnabled;
+
+		// reused for serializing all outgoing JSON messages
+		std::unique_ptr<Json::StreamWriter> m_jsonWriter;
+		std::ostringstream m_sendStream;
+
+		// binary messages sent since the last flush()
+		std::string m_binaryBatch;
+		std::size_t m_binaryBatchCount;
+
+		NetStats m_netStats;
+		uint64_t m_lastPingTime;
+
+		bool m_latencyLogging;
+		// time of the input handled since the last flush(), 0 if none
+		uint64_t m_inputTime;
+		// input time of the last stamped game messages received,
+		// until their result was rendered. 0 if there are none.
+		uint64_t m_remoteInputTime;
+
+		// number of game messages sent
+		uint32_t m_gameMsgSeq;
+		// whether the current batch already contains a SEQ message
+		bool m_batchHasSeq;
+
+		// game messages that weren't confirmed by the remote end yet, in
+		// the binary format, to send them again after a reconnect. Messages
+		// sent as JSON are kept too, in case the HELLO of the remote end
+		// only arrives later. Remote ends which never send one also never
+		// confirm anything, but one game only has a few hundred messages.
+		std::deque<std::pair<uint32_t, std::string>> m_unconfirmed;
+
+		// sequence number of the last game message received
+		uint32_t m_lastIncomingSeq;
+		// sequence number of the next game message in the current batch, 0 if unknown
+		uint32_t m_nextIncomingSeq;
+		// when the last RESYNC was sent, 0 if it was answered
+		uint64_t m_resyncTime;
+
+		// sends a binary message without adding it to the batch
+		void sendBinaryNow(const std::string&);
+
+		void dropConfirmed(uint32_t seq);
+		// sends all unconfirmed messages after seq again, preceded by a
+		// SEQ message that is also sent if there are none, as the answer
+		// to a RESYNC
+		void resend(uint32_t seq);
+		// asks the remote end for the game messages that didn't arrive,
+		// repeated every resyncInterval ms until it answers
+		void requestResync();
+
 		// implemented as singleton because one game can only
 		// be connected to one websocket remote end at once
 		static CyvasseWSClient* s_instance;
@@ -39,13 +106,89 @@ class CyvasseWSClient
 		CyvasseWSClient& operator=(const CyvasseWSClient&) = delete;
 
 		std::function<void(const Json::Value&)> handleMessage;
+		// called for all binary game messages, with their sequence number.
+		// Messages only used by the protocol are handled by the client itself,
+		// as well as duplicate game messages after a reconnect.
+		std::function<void(const std::string&, uint32_t)> handleBinaryMessage;
+
+		// called when the remote end confirmed having handled all game messages
+		// up to the given sequence number, or rejected the game message with it
+		std::function<void(uint32_t)> onAck;
+		std::function<void(uint32_t)> onReject;
 
 		static CyvasseWSClient& instance();
 
 		void handleMessageWrap(const std::string&);
+		void handleMessageWrap(const char* data, std::size_t size);
+		void handleBinaryMessageWrap(const std::string&);
+		void handleBinaryMessageWrap(const char* data, std::size_t size);
+
+		void connect(const std::string& uri);
+		// processes all messages that were received since the last call
+		void poll();
+
+		// announces that this client understands binary game messages
+		void sendHello();
+
+		// whether game messages should be sent in the binary format
+		bool useBinary() const
+		{ return m_binaryEnabled && m_remoteBinaryVersion > 0; }
+
+		// can be used to force sending JSON, e.g. for debugging
+		void setBinaryEnabled(bool enabled)
+		{ m_binaryEnabled = enabled; }
 
 		void send(const std::string&);
+		void send(const char* data, std::size_t size);
+		// serializes with a writer and stream that are reused for all messages
 		void send(const Json::Value&);
+		// binary messages are queued and sent together by the next flush()
+		void sendBinary(const std::string&);
+
+		// sends all queued binary messages in one frame and pings the
+		// remote end every pingInterval ms. A single message is sent
+		// without the batch envelope.
+		// Called once per main loop iteration by CyvasseApp.
+		void flush();
+
+		static const uint64_t pingInterval = 2000;
+		static const uint64_t resyncInterval = 1000;
+
+		// Game messages are numbered from 1 in the order they are sent.
+		// These send one and return its sequence number. A JSON message
+		// also needs its binary form, in case it has to be sent again.
+		uint32_t sendGameMsg(const Json::Value&, const std::string& binaryMsg);
+		uint32_t sendBinaryGameMsg(const std::string&);
+
+		// returns the sequence number of a received JSON game
+		// message, which doesn't contain it explicitly
+		uint32_t nextIncomingSeq()
+		{ return ++m_lastIncomingSeq; }
+
+		// has to be called when the connection was lost and established again.
+		// Asks the remote end for all game messages that got lost in between.
+		// The RESYNC also tells the remote end which own messages it should
+		// have received, so it asks for the lost ones in turn.
+		void onReconnected();
+
+		// only filled when the remote end understands binary messages
+		const NetStats& getNetStats() const
+		{ return m_netStats; }
+
+		// Measures the time from a click to the remote end rendering its
+		// result and logs it. Only then are the game messages caused by
+		// user input preceded by a TIMESTAMP message with the input time.
+		void setLatencyLogging(bool enabled)
+		{ m_latencyLogging = enabled; }
+
+		// called by the input handling when user input arrives, the game
+		// messages sent until the next flush() are stamped with the time
+		void setInputTime(uint64_t time)
+		{ m_inputTime = time; }
+
+		// has to be called after a frame was displayed,
+		// completes the latency measurement of received messages
+		void frameRendered();
 };
 
 #endif // _CYVASSE_WS_CLIENT_HPP_
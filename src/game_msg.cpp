@@ -0,0 +1,162 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "game_msg.hpp"
+
+#include <cstring>
+#include <cyvws/game_msg.hpp>
+#include <cyvws/json_game_msg.hpp>
+#include "binary_game_msg.hpp"
+#include "cyvasse_ws_client.hpp"
+
+using namespace std;
+using namespace cyvmath;
+using namespace cyvmath::mikelepage;
+using namespace cyvws;
+
+namespace gamemsg
+{
+	// open addressing table from name hashes to actions, with more than
+	// twice as many slots as actions so nearly every lookup takes one probe
+	static const size_t nameTableSize = 16;
+	static_assert(nameTableSize >= actionCount * 2, "name table is too small");
+
+	typedef array<int8_t, nameTableSize> NameTable;
+
+	// FNV-1a
+	static uint32_t hashName(const char* name)
+	{
+		uint32_t hash = 2166136261u;
+		for(; *name; name++)
+			hash = (hash ^ static_cast<uint8_t>(*name)) * 16777619u;
+
+		return hash;
+	}
+
+	static const NameTable& getNameTable()
+	{
+		// built on first use, because the action names are defined
+		// in cyvws and may not be initialized during static init
+		static const NameTable table = [] {
+			NameTable ret;
+			ret.fill(-1);
+
+			for(size_t i = 0; i < actionCount; i++)
+			{
+				size_t slot = hashName(actionName(static_cast<Action>(i)).c_str()) % nameTableSize;
+				while(ret[slot] != -1)
+					slot = (slot + 1) % nameTableSize;
+
+				ret[slot] = static_cast<int8_t>(i);
+			}
+
+			return ret;
+		}();
+
+		return table;
+	}
+
+	const string& actionName(Action action)
+	{
+		static const array<const string*, actionCount> names {{
+			&GameMsgAction::SET_OPENING_ARRAY,
+			&GameMsgAction::SET_IS_READY,
+			&GameMsgAction::MOVE,
+			&GameMsgAction::MOVE_CAPTURE,
+			&GameMsgAction::PROMOTE,
+			&GameMsgAction::RESIGN
+		}};
+
+		return *names[static_cast<size_t>(action)];
+	}
+
+	optional<Action> actionFromName(const char* name)
+	{
+		const NameTable& table = getNameTable();
+
+		for(size_t slot = hashName(name) % nameTableSize; table[slot] != -1; slot = (slot + 1) % nameTableSize)
+		{
+			Action action = static_cast<Action>(table[slot]);
+			if(strcmp(actionName(action).c_str(), name) == 0)
+				return action;
+		}
+
+		return nullopt;
+	}
+
+	uint32_t sendSetOpeningArray(const ActivePieceMap& pieces)
+	{
+		auto& client = CyvasseWSClient::instance();
+
+		if(client.useBinary())
+			return client.sendBinaryGameMsg(binary::gameMsgSetOpeningArray(pieces));
+		else
+			return client.sendGameMsg(json::gameMsgSetOpeningArray(pieces), binary::gameMsgSetOpeningArray(pieces));
+	}
+
+	uint32_t sendSetIsReady()
+	{
+		auto& client = CyvasseWSClient::instance();
+
+		if(client.useBinary())
+			return client.sendBinaryGameMsg(binary::gameMsgSetIsReady());
+		else
+			return client.sendGameMsg(json::gameMsgSetIsReady(), binary::gameMsgSetIsReady());
+	}
+
+	uint32_t sendMove(PieceType type, Coordinate oldPos, Coordinate newPos)
+	{
+		auto& client = CyvasseWSClient::instance();
+
+		if(client.useBinary())
+			return client.sendBinaryGameMsg(binary::gameMsgMove(type, oldPos, newPos));
+		else
+			return client.sendGameMsg(json::gameMsgMove(type, oldPos, newPos), binary::gameMsgMove(type, oldPos, newPos));
+	}
+
+	uint32_t sendMoveCapture(PieceType atkPT, Coordinate oldPos, Coordinate newPos, PieceType defPT, Coordinate defPiecePos)
+	{
+		auto& client = CyvasseWSClient::instance();
+
+		if(client.useBinary())
+			return client.sendBinaryGameMsg(binary::gameMsgMoveCapture(atkPT, oldPos, newPos, defPT, defPiecePos));
+		else
+			return client.sendGameMsg(
+				json::gameMsgMoveCapture(atkPT, oldPos, newPos, defPT, defPiecePos),
+				binary::gameMsgMoveCapture(atkPT, oldPos, newPos, defPT, defPiecePos)
+			);
+	}
+
+	uint32_t sendPromote(PieceType origType, PieceType newType)
+	{
+		auto& client = CyvasseWSClient::instance();
+
+		if(client.useBinary())
+			return client.sendBinaryGameMsg(binary::gameMsgPromote(origType, newType));
+		else
+			return client.sendGameMsg(json::gameMsgPromote(origType, newType), binary::gameMsgPromote(origType, newType));
+	}
+
+	uint32_t sendResign()
+	{
+		auto& client = CyvasseWSClient::instance();
+
+		if(client.useBinary())
+			return client.sendBinaryGameMsg(binary::gameMsgResign());
+		else
+			return client.sendGameMsg(json::gameMsgResign(), binary::gameMsgResign());
+	}
+}
@@ -0,0 +1,92 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _GAME_MSG_HPP_
+#define _GAME_MSG_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <optional.hpp>
+#include <cyvmath/coordinate.hpp>
+#include <cyvmath/piece_type.hpp>
+#include <cyvmath/mikelepage/match.hpp>
+
+namespace gamemsg
+{
+	// the values are also used as action ids in the binary format,
+	// so new actions have to be added at the end
+	enum class Action : uint8_t
+	{
+		SET_OPENING_ARRAY,
+		SET_IS_READY,
+		MOVE,
+		MOVE_CAPTURE,
+		PROMOTE,
+		RESIGN
+	};
+
+	const std::size_t actionCount = static_cast<std::size_t>(Action::RESIGN) + 1;
+
+	// name of the action in JSON messages (one of cyvws::GameMsgAction)
+	const std::string& actionName(Action);
+	// hash table lookup of the action with the given name,
+	// returns nullopt if no action has that name
+	optional<Action> actionFromName(const char* name);
+
+	/* Table of handler functions for incoming game messages, indexed by
+	 * their action. Args are the parameters passed to every handler.
+	 */
+	template<class... Args>
+	class Dispatcher
+	{
+		public:
+			typedef std::function<void(Args...)> Handler;
+
+		private:
+			std::array<Handler, actionCount> m_handlers;
+
+		public:
+			void set(Action action, Handler handler)
+			{ m_handlers[static_cast<std::size_t>(action)] = std::move(handler); }
+
+			// throws a std::runtime_error if no handler was set for action
+			void dispatch(Action action, Args... args) const
+			{
+				const Handler& handler = m_handlers[static_cast<std::size_t>(action)];
+				if(!handler)
+					throw std::runtime_error("got a game message with unhandled action " + actionName(action));
+
+				handler(args...);
+			}
+	};
+
+	// These send game messages to the remote end, in the binary format
+	// if it supports that and as JSON otherwise. They return the
+	// sequence number of the message (see CyvasseWSClient::sendGameMsg)
+	uint32_t sendSetOpeningArray(const cyvmath::mikelepage::ActivePieceMap&);
+	uint32_t sendSetIsReady();
+	uint32_t sendMove(cyvmath::PieceType, cyvmath::Coordinate oldPos, cyvmath::Coordinate newPos);
+	uint32_t sendMoveCapture(cyvmath::PieceType atkPT, cyvmath::Coordinate oldPos, cyvmath::Coordinate newPos,
+		cyvmath::PieceType defPT, cyvmath::Coordinate defPiecePos);
+	uint32_t sendPromote(cyvmath::PieceType origType, cyvmath::PieceType newType);
+	uint32_t sendResign();
+}
+
+#endif // _GAME_MSG_HPP_
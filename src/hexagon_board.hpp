@@ -17,6 +17,9 @@
 #ifndef _HEXAGON_BOARD_HPP_
 #define _HEXAGON_BOARD_HPP_
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <map>
 #include <memory>
 #include <vector>
@@ -28,6 +31,9 @@
 #include <optional.hpp>
 #include <cyvmath/hexagon.hpp>
 #include <cyvmath/players_color.hpp>
+#include "hexagon_index.hpp"
+#include "hexagon_tables.hpp"
+#include "quad_mesh.hpp"
 
 // order of elements here determines order of
 // queuing for rendering -> visual z-order
@@ -40,16 +46,26 @@ enum class HighlightingId
 	HOVER
 };
 
+const std::size_t highlightingIdCount = static_cast<std::size_t>(HighlightingId::HOVER) + 1;
+
 template<int l>
 class HexagonBoard
 {
 	public:
 		typedef typename cyvmath::Hexagon<l> Hexagon;
 		typedef typename Hexagon::Coordinate Coordinate;
-		typedef typename std::pair<Coordinate, std::shared_ptr<fea::Quad>> Tile;
-		typedef typename std::map<Coordinate, std::shared_ptr<fea::Quad>> TileMap;
-		typedef std::vector<std::shared_ptr<fea::Quad>> QuadVec;
-		typedef std::map<HighlightingId, QuadVec> HighlightQuadMap;
+		typedef HexagonIndex<l> Index;
+		typedef HexagonTables<l> Tables;
+
+		// preallocated overlay quads for one HighlightingId,
+		// of which only the first [used] ones are rendered
+		struct HighlightLayer
+		{
+			std::array<fea::Quad, Index::tileCount> quads;
+			// the tile index of every quad, to reposition it on relayout
+			std::array<std::size_t, Index::tileCount> tiles;
+			std::size_t used = 0;
+		};
 
 		static const fea::Color tileColors[3];
 
@@ -67,17 +83,41 @@ class HexagonBoard
 		glm::uvec2 m_size;
 		glm::uvec2 m_position;
 		glm::vec2 m_tileSize;
+		// 1 / m_tileSize, for getCoordinate()
+		glm::vec2 m_invTileSize;
+
+		// screen positions of all tiles, by Index::index()
+		std::array<glm::vec2, Index::tileCount> m_tilePositions;
+
+		// all tiles baked into one mesh, rendered
+		// in one draw call instead of one per tile
+		QuadMesh m_tileMesh;
+
+		optional<Coordinate> m_hoveredTile;
+		optional<Coordinate> m_mouseBPressTile;
 
-		TileMap m_tileMap;
-		QuadVec m_quadVec;
+		std::array<HighlightLayer, highlightingIdCount> m_highlightLayers;
 
-		optional<Tile> m_hoveredTile;
-		optional<Tile> m_mouseBPressTile;
+		// std::floor() is a library call on targets without SSE4.1,
+		// converting to int and correcting negative values is not
+		static int floorToInt(float v)
+		{
+			int i = static_cast<int>(v);
+			return i - (v < i);
+		}
 
-		HighlightQuadMap m_highlightQuads;
+		static int ceilToInt(float v)
+		{
+			int i = static_cast<int>(v);
+			return i + (v > i);
+		}
 
 		fea::Color getTileColor(Coordinate);
-		std::shared_ptr<fea::Quad> createHighlightQuad(glm::vec2 pos, HighlightingId);
+		glm::vec2 calcTilePosition(Coordinate);
+		void buildTileMesh();
+		void changed();
+		HighlightLayer& getHighlightLayer(HighlightingId id)
+		{ return m_highlightLayers[static_cast<std::size_t>(id)]; }
 
 	public:
 		HexagonBoard(fea::Renderer2D&, cyvmath::PlayersColor);
@@ -90,17 +130,33 @@ class HexagonBoard
 		std::function<void(Coordinate)> onTileClicked;
 		std::function<void(const fea::Event::MouseMoveEvent&)> onMouseMoveOutside;
 		std::function<void(const fea::Event::MouseButtonEvent&)> onClickedOutside;
+		// called whenever the visual appearance of the board changed
+		std::function<void()> onChanged;
+
+		// recalculates the positions and sizes of all tiles and
+		// highlightings, to be called when the window was resized
+		void updateLayout(glm::uvec2 windowSize);
 
 		glm::uvec2 getSize();
 		glm::uvec2 getPosition();
 
-		glm::vec2 getTilePosition(Coordinate);
+		// positions are only calculated when the layout changes,
+		// so these are simple lookups
+		const glm::vec2& getTilePosition(std::size_t index) const
+		{ return m_tilePositions[index]; }
+
+		const glm::vec2& getTilePosition(Coordinate c) const
+		{ return m_tilePositions[Index::index(c)]; }
+
 		const glm::vec2& getTileSize() const;
 
 		template<class... Args>
 		optional<Coordinate> getCoordinate(Args&&... args);
 
-		std::shared_ptr<fea::Quad> getTileAt(Coordinate);
+		// the tile at pos, relative to the top left corner of a board with
+		// the given size and orientation. Used by getCoordinate(), and
+		// static so it can be benchmarked without a renderer.
+		static optional<Coordinate> tileAt(glm::vec2 pos, glm::vec2 boardSize, glm::vec2 invTileSize, bool upsideDown);
 
 		void highlightTile(Coordinate, HighlightingId);
 
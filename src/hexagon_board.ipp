@@ -38,28 +38,37 @@ fea::Color HexagonBoard<l>::getTileColor(Coordinate c)
 }
 
 template <int l>
-std::shared_ptr<fea::Quad> HexagonBoard<l>::createHighlightQuad(glm::vec2 pos, HighlightingId id)
+HexagonBoard<l>::HexagonBoard(fea::Renderer2D& renderer, cyvmath::PlayersColor color)
+	: m_renderer(renderer)
+	, m_upsideDown(color == cyvmath::PlayersColor::WHITE ? false : true)
 {
-	auto ret = std::make_shared<fea::Quad>(getTileSize());
+	for(auto&& it : highlightingColors)
+		for(auto&& quad : getHighlightLayer(it.first).quads)
+			quad.setColor(it.second);
 
-	ret->setPosition(pos);
-	ret->setColor(highlightingColors.at(id));
+	updateLayout(renderer.getViewport().getSize());
 
-	return ret;
+	std::vector<Coordinate> tmpVec;
+	tmpVec.reserve(Index::tileCount);
+
+	for(std::size_t i = 0; i < Index::tileCount; i++)
+	{
+		if((!m_upsideDown && Tables::y(i) >= (l - 1)) ||
+		   (m_upsideDown && Tables::y(i) <= (l - 1)))
+			tmpVec.push_back(Tables::coordinate(i));
+	}
+
+	highlightTiles(tmpVec.begin(), tmpVec.end(), HighlightingId::DIM);
 }
 
 template <int l>
-HexagonBoard<l>::HexagonBoard(fea::Renderer2D& renderer, cyvmath::PlayersColor color)
-	: m_renderer(renderer)
-	, m_upsideDown(color == cyvmath::PlayersColor::WHITE ? false : true)
+void HexagonBoard<l>::updateLayout(glm::uvec2 windowSize)
 {
-	const glm::uvec2 windowSize = renderer.getViewport().getSize();
-
 	unsigned padding = std::min(windowSize.x, windowSize.y) / 40;
 
 	m_size = {windowSize.x - padding * 2, windowSize.y - padding * 2};
 
-	if(m_size.x / m_size.y < 4.0f / 3.0f) // wider than 4:3
+	if(static_cast<float>(m_size.x) / m_size.y >= 4.0f / 3.0f) // wider than 4:3
 	{
 		m_tileSize.y = m_size.y / static_cast<float>(l * 2 - 1);
 		m_tileSize.x = m_tileSize.y / 3.0f * 4.0f;
@@ -73,33 +82,46 @@ HexagonBoard<l>::HexagonBoard(fea::Renderer2D& renderer, cyvmath::PlayersColor c
 		m_tileSize.x = m_size.x / static_cast<float>(l * 2 - 1);
 		m_tileSize.y = m_tileSize.x / 4.0f * 3.0f;
 
-		m_size.y = m_tileSize.x * (l * 2 - 1);
+		m_size.y = m_tileSize.y * (l * 2 - 1);
 
 		m_position = {padding, (windowSize.y - m_size.y) / 2.0f};
 	}
 
-	std::vector<Coordinate> tmpVec;
-	tmpVec.reserve(Hexagon::tileCount + (Hexagon::edgeLength * 2) - 1);
+	m_invTileSize = {1.0f / m_tileSize.x, 1.0f / m_tileSize.y};
+
+	// everything that depends on the layout is derived from
+	// this table, so it is only calculated once per layout
+	for(std::size_t i = 0; i < Index::tileCount; i++)
+		m_tilePositions[i] = calcTilePosition(Tables::coordinate(i));
 
-	for(Coordinate c : Hexagon::allCoordinates)
+	for(auto&& layer : m_highlightLayers)
 	{
-		auto quad = std::make_shared<fea::Quad>(m_tileSize);
+		for(auto&& quad : layer.quads)
+			quad.setSize(m_tileSize);
 
-		quad->setPosition(getTilePosition(c));
-		quad->setColor(getTileColor(c));
+		for(std::size_t i = 0; i < layer.used; i++)
+			layer.quads[i].setPosition(m_tilePositions[layer.tiles[i]]);
+	}
 
-		if((!m_upsideDown && c.y() >= (l - 1)) ||
-		   (m_upsideDown && c.y() <= (l - 1)))
-			tmpVec.push_back(c);
+	buildTileMesh();
+	changed();
+}
 
-		// add the tile to the map and vector
-		m_quadVec.push_back(quad);
-		auto res = m_tileMap.emplace(c, quad);
+template <int l>
+void HexagonBoard<l>::buildTileMesh()
+{
+	m_tileMesh.clear();
+	m_tileMesh.reserve(Index::tileCount);
 
-		assert(res.second); // assert the insertion was successful
-	}
+	for(std::size_t i = 0; i < Index::tileCount; i++)
+		m_tileMesh.addQuad(m_tilePositions[i], m_tileSize, getTileColor(Tables::coordinate(i)));
+}
 
-	highlightTiles(tmpVec.begin(), tmpVec.end(), HighlightingId::DIM);
+template <int l>
+void HexagonBoard<l>::changed()
+{
+	if(onChanged)
+		onChanged();
 }
 
 template <int l>
@@ -115,7 +137,7 @@ glm::uvec2 HexagonBoard<l>::getPosition()
 }
 
 template <int l>
-glm::vec2 HexagonBoard<l>::getTilePosition(Coordinate c)
+glm::vec2 HexagonBoard<l>::calcTilePosition(Coordinate c)
 {
 	glm::vec2 ret;
 
@@ -164,64 +186,46 @@ template<class... Args>
 optional<typename HexagonBoard<l>::Coordinate> HexagonBoard<l>::getCoordinate(Args&&... args)
 {
 	// remove padding
-	glm::uvec2 tilePos = glm::uvec2(std::forward<Args>(args)...) - m_position;
+	glm::vec2 pos = glm::vec2(std::forward<Args>(args)...) - glm::vec2(m_position);
 
-	float x, y;
+	return tileAt(pos, glm::vec2(m_size), m_invTileSize, m_upsideDown);
+}
 
-	if(!m_upsideDown) // 'normal' orientation first
+template<int l>
+optional<typename HexagonBoard<l>::Coordinate> HexagonBoard<l>::tileAt(glm::vec2 pos, glm::vec2 boardSize, glm::vec2 invTileSize, bool upsideDown)
+{
+	// this is the inverse of calcTilePosition(): every row is shifted
+	// horizontally by half a tile relative to the one below it (in the
+	// normal orientation). The tiles include their top and left edges,
+	// so where a position is measured from the bottom or right edge of
+	// the board, the tile index is rounded up instead of down.
+	int x, y;
+
+	if(!upsideDown)
 	{
-		// y = (maximal y) - ('inverted' coord y)
-		y = (l * 2 - 1)
-			- tilePos.y / m_tileSize.y;
-
-		x = (
-				tilePos.x
-				+ ((l - static_cast<int>(y)) * m_tileSize.x / 2.0f)
-				- m_tileSize.x / 2.0f
-			)
-			/ m_tileSize.x;
+		y = ceilToInt((boardSize.y - pos.y) * invTileSize.y) - 1;
+		x = floorToInt(pos.x * invTileSize.x - (y - (l - 1)) / 2.0f);
 	}
-	else // upsideDown
+	else
 	{
-		y = tilePos.y / m_tileSize.y;
-
-		x = (l * 2 - 1)
-			- ((
-					tilePos.x
-					- ((l - static_cast<int>(y)) * m_tileSize.x / 2.0f)
-					+ m_tileSize.x / 2.0f
-				)
-				/ m_tileSize.x
-			);
+		y = floorToInt(pos.y * invTileSize.y);
+		x = ceilToInt((boardSize.x - pos.x) * invTileSize.x - (y - (l - 1)) / 2.0f) - 1;
 	}
 
-	if(x < 0.0f || y < 0.0f)
-		return nullopt;
-
-	return Coordinate::create(static_cast<int>(x), static_cast<int>(y));
-}
-
-template <int l>
-std::shared_ptr<fea::Quad> HexagonBoard<l>::getTileAt(Coordinate c)
-{
-	typename TileMap::iterator it = m_tileMap.find(c);
-	if(it == m_tileMap.end())
-		return nullptr;
-
-	return it->second;
+	// returns nullopt for positions outside the hexagon
+	return Coordinate::create(x, y);
 }
 
 template <int l>
 void HexagonBoard<l>::highlightTile(Coordinate coord, HighlightingId id)
 {
-	auto res = m_highlightQuads.emplace(id, QuadVec());
-	auto& quadVec = res.first->second;
+	auto& layer = getHighlightLayer(id);
 
-	// the check could maybe be removed
-	if(!res.second)
-		quadVec.clear();
+	layer.tiles[0] = Index::index(coord);
+	layer.quads[0].setPosition(m_tilePositions[layer.tiles[0]]);
+	layer.used = 1;
 
-	quadVec.push_back(createHighlightQuad(getTilePosition(coord), id));
+	changed();
 }
 
 template <int l>
@@ -233,37 +237,42 @@ void HexagonBoard<l>::highlightTiles(InputIterator first, InputIterator last, Hi
 		"The iterators first and last have to be convertible to Coordinate"
 	);
 
-	auto res = m_highlightQuads.emplace(id, QuadVec());
-	auto& quadVec = res.first->second;
-
-	// the check could maybe be removed
-	if(!res.second)
-		quadVec.clear();
+	auto& layer = getHighlightLayer(id);
+	layer.used = 0;
 
 	while(first != last)
 	{
-		quadVec.push_back(createHighlightQuad(getTilePosition(*first), id));
+		assert(layer.used < layer.quads.size());
+
+		layer.tiles[layer.used] = Index::index(*first);
+		layer.quads[layer.used].setPosition(m_tilePositions[layer.tiles[layer.used]]);
+		layer.used++;
 		++first;
 	}
+
+	changed();
 }
 
 template <int l>
 void HexagonBoard<l>::clearHighlighting(HighlightingId id)
 {
-	auto res = m_highlightQuads.find(id);
-	if(res != m_highlightQuads.end())
-		res->second.clear();
+	auto& layer = getHighlightLayer(id);
+
+	if(layer.used > 0)
+	{
+		layer.used = 0;
+		changed();
+	}
 }
 
 template <int l>
 void HexagonBoard<l>::tick()
 {
-	for(auto&& it : m_quadVec)
-		m_renderer.queue(*it);
+	m_renderer.queue(m_tileMesh);
 
-	for(auto&& vecIt : m_highlightQuads)
-		for(auto&& quadIt : vecIt.second)
-			m_renderer.queue(*quadIt);
+	for(auto&& layer : m_highlightLayers)
+		for(std::size_t i = 0; i < layer.used; i++)
+			m_renderer.queue(layer.quads[i]);
 }
 
 template <int l>
@@ -273,12 +282,10 @@ void HexagonBoard<l>::onMouseMoved(const fea::Event::MouseMoveEvent& mouseMove)
 
 	if(coord) // mouse hovers on tile (*coord)
 	{
-		auto quad = getTileAt(*coord);
-
-		if(!m_hoveredTile || *coord != m_hoveredTile->first)
+		if(!m_hoveredTile || *coord != *m_hoveredTile)
 		{
 			highlightTile(*coord, HighlightingId::HOVER);
-			m_hoveredTile = Tile(*coord, quad);
+			m_hoveredTile = coord;
 
 			onTileMouseOver(*coord);
 		}
@@ -305,7 +312,7 @@ void HexagonBoard<l>::onMouseButtonPressed(const fea::Event::MouseButtonEvent& m
 	auto coord = getCoordinate(mouseButton.x, mouseButton.y);
 
 	if(coord)
-		m_mouseBPressTile = Tile(*coord, getTileAt(*coord));
+		m_mouseBPressTile = coord;
 	else
 		onClickedOutside(mouseButton);
 }
@@ -317,7 +324,7 @@ void HexagonBoard<l>::onMouseButtonReleased(const fea::Event::MouseButtonEvent&
 	{
 		auto coord = getCoordinate(mouseButton.x, mouseButton.y);
 
-		if(coord && *coord == m_mouseBPressTile->first)
+		if(coord && *coord == *m_mouseBPressTile)
 			onTileClicked(*coord);
 
 		m_mouseBPressTile = nullopt;
@@ -0,0 +1,99 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _HEXAGON_INDEX_HPP_
+#define _HEXAGON_INDEX_HPP_
+
+#include <cassert>
+#include <cstddef>
+#include <cyvmath/coordinate.hpp>
+#include <cyvmath/hexagon.hpp>
+
+/* Maps the coordinates of a cyvmath::Hexagon<l> to the dense
+ * range [0, tileCount), so per-tile data can be stored in
+ * plain arrays instead of maps keyed by Coordinate.
+ *
+ * Tiles are numbered row by row, starting at y = 0, and
+ * from the lowest to the highest x inside of every row.
+ */
+template<int l>
+class HexagonIndex
+{
+	public:
+		static constexpr int edgeLength = l;
+		static constexpr std::size_t tileCount = 3 * l * (l - 1) + 1;
+
+		static constexpr int rowCount = l * 2 - 1;
+
+		static_assert(tileCount == cyvmath::Hexagon<l>::tileCount, "tile count mismatch");
+
+		static constexpr bool isValid(int x, int y)
+		{
+			return x >= 0 && y >= 0 && x < rowCount && y < rowCount &&
+			       x + y >= l - 1 && x + y <= (l - 1) * 3;
+		}
+
+		// lowest x coordinate of a tile in row y
+		static constexpr int rowBegin(int y)
+		{
+			return y < l ? (l - 1) - y : 0;
+		}
+
+		static constexpr int rowLength(int y)
+		{
+			return y < l ? l + y : (l * 3 - 2) - y;
+		}
+
+		// index of the first tile in row y
+		static constexpr std::size_t rowOffset(int y)
+		{
+			std::size_t ret = 0;
+			for(int i = 0; i < y; i++)
+				ret += rowLength(i);
+
+			return ret;
+		}
+
+		static constexpr std::size_t index(int x, int y)
+		{
+			return rowOffset(y) + (x - rowBegin(y));
+		}
+
+		static std::size_t index(const cyvmath::Coordinate& c)
+		{
+			assert(isValid(c.x(), c.y()));
+			return index(c.x(), c.y());
+		}
+
+		// the inverse of index()
+		static typename cyvmath::Hexagon<l>::Coordinate coordinate(std::size_t index)
+		{
+			assert(index < tileCount);
+
+			int y = 0;
+			while(index >= rowOffset(y + 1))
+				y++;
+
+			return typename cyvmath::Hexagon<l>::Coordinate(rowBegin(y) + static_cast<int>(index - rowOffset(y)), y);
+		}
+};
+
+static_assert(HexagonIndex<6>::tileCount == 91, "");
+static_assert(HexagonIndex<6>::index(5, 0) == 0, "");
+static_assert(HexagonIndex<6>::index(0, 5) == HexagonIndex<6>::rowOffset(5), "");
+static_assert(HexagonIndex<6>::index(5, 10) == 90, "");
+
+#endif // _HEXAGON_INDEX_HPP_
@@ -0,0 +1,210 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _HEXAGON_TABLES_HPP_
+#define _HEXAGON_TABLES_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include "bitboard.hpp"
+#include "hexagon_index.hpp"
+
+// y grows upwards, so TOP_RIGHT is (0, +1) and TOP_LEFT is (-1, +1).
+// The six directions to adjacent tiles come first, followed by
+// the six diagonal ones, each between two adjacent directions.
+enum class HexDirection
+{
+	RIGHT,
+	TOP_RIGHT,
+	TOP_LEFT,
+	LEFT,
+	BOTTOM_LEFT,
+	BOTTOM_RIGHT,
+	DIAGONAL_TOP_RIGHT,
+	DIAGONAL_TOP,
+	DIAGONAL_TOP_LEFT,
+	DIAGONAL_BOTTOM_LEFT,
+	DIAGONAL_BOTTOM,
+	DIAGONAL_BOTTOM_RIGHT
+};
+
+const std::size_t hexDirectionCount = static_cast<std::size_t>(HexDirection::DIAGONAL_BOTTOM_RIGHT) + 1;
+
+/* Geometry of a cyvmath::Hexagon<l>, computed at compile time and
+ * indexed by HexagonIndex<l>: the coordinates of every tile, the next
+ * tile in every direction, the rays from every tile in every direction,
+ * the distance between any two tiles and the tiles within a distance.
+ * All of it is a table lookup instead of coordinate arithmetic.
+ */
+template<int l>
+class HexagonTables
+{
+	public:
+		typedef HexagonIndex<l> Index;
+
+		static constexpr std::size_t tileCount = Index::tileCount;
+		static constexpr int maxDistance = (l - 1) * 2;
+
+		// returned by step() when the next tile is outside the board
+		static constexpr std::size_t noTile = tileCount;
+
+		static_assert(tileCount <= Bitboard::size, "the hexagon is too big for a Bitboard");
+
+	private:
+		struct Offset
+		{
+			int x, y;
+		};
+
+		static constexpr Offset offsets[hexDirectionCount] = {
+			{ 1,  0}, { 0,  1}, {-1,  1}, {-1,  0}, { 0, -1}, { 1, -1},
+			{ 1,  1}, {-1,  2}, {-2,  1}, {-1, -1}, { 1, -2}, { 2, -1}
+		};
+
+		struct Data
+		{
+			int8_t x[tileCount];
+			int8_t y[tileCount];
+			uint8_t steps[tileCount][hexDirectionCount];
+			Bitboard rays[tileCount][hexDirectionCount];
+			uint8_t distances[tileCount][tileCount];
+			// tiles with exactly / at most the given distance
+			Bitboard rings[tileCount][maxDistance + 1];
+			Bitboard areas[tileCount][maxDistance + 1];
+		};
+
+		static constexpr int abs(int v)
+		{ return v < 0 ? -v : v; }
+
+		static constexpr Data build()
+		{
+			Data d{};
+
+			for(std::size_t i = 0; i < tileCount; i++)
+			{
+				// same order as Index::coordinate()
+				int y = 0;
+				while(i >= Index::rowOffset(y + 1))
+					y++;
+
+				d.x[i] = static_cast<int8_t>(Index::rowBegin(y) + static_cast<int>(i - Index::rowOffset(y)));
+				d.y[i] = static_cast<int8_t>(y);
+			}
+
+			for(std::size_t i = 0; i < tileCount; i++)
+			{
+				for(std::size_t dir = 0; dir < hexDirectionCount; dir++)
+				{
+					int x = d.x[i] + offsets[dir].x;
+					int y = d.y[i] + offsets[dir].y;
+
+					d.steps[i][dir] = static_cast<uint8_t>(Index::isValid(x, y) ? Index::index(x, y) : noTile);
+
+					while(Index::isValid(x, y))
+					{
+						d.rays[i][dir].set(Index::index(x, y));
+
+						x += offsets[dir].x;
+						y += offsets[dir].y;
+					}
+				}
+
+				for(std::size_t j = 0; j < tileCount; j++)
+				{
+					int dx = d.x[j] - d.x[i];
+					int dy = d.y[j] - d.y[i];
+					int dist = (abs(dx) + abs(dy) + abs(dx + dy)) / 2;
+
+					d.distances[i][j] = static_cast<uint8_t>(dist);
+					d.rings[i][dist].set(j);
+				}
+
+				d.areas[i][0] = d.rings[i][0];
+				for(int dist = 1; dist <= maxDistance; dist++)
+					d.areas[i][dist] = d.areas[i][dist - 1] | d.rings[i][dist];
+			}
+
+			return d;
+		}
+
+		static constexpr Data data = build();
+
+	public:
+		static constexpr int x(std::size_t index)
+		{ return data.x[index]; }
+
+		static constexpr int y(std::size_t index)
+		{ return data.y[index]; }
+
+		// faster version of Index::coordinate()
+		static typename cyvmath::Hexagon<l>::Coordinate coordinate(std::size_t index)
+		{ return typename cyvmath::Hexagon<l>::Coordinate(x(index), y(index)); }
+
+		// the adjacent (or diagonally next) tile, or noTile
+		static constexpr std::size_t step(std::size_t index, HexDirection dir)
+		{ return data.steps[index][static_cast<std::size_t>(dir)]; }
+
+		// all tiles from index (exclusive) to the edge of the board
+		static constexpr Bitboard ray(std::size_t index, HexDirection dir)
+		{ return data.rays[index][static_cast<std::size_t>(dir)]; }
+
+		// whether the tile indices along dir are increasing, which
+		// decides if the nearest tile of a ray is its first or last bit
+		static constexpr bool isAscending(HexDirection dir)
+		{
+			return offsets[static_cast<std::size_t>(dir)].y > 0 ||
+			       (offsets[static_cast<std::size_t>(dir)].y == 0 && offsets[static_cast<std::size_t>(dir)].x > 0);
+		}
+
+		static constexpr int distance(std::size_t a, std::size_t b)
+		{ return data.distances[a][b]; }
+
+		static constexpr Bitboard ring(std::size_t index, int dist)
+		{ return data.rings[index][dist]; }
+
+		// all tiles with a distance of at most dist, including index itself
+		static constexpr Bitboard area(std::size_t index, int dist)
+		{ return data.areas[index][dist > maxDistance ? maxDistance : dist]; }
+
+		// the tiles a piece on index could move to along dir,
+		// up to and including the first tile in occupied
+		static Bitboard slide(std::size_t index, HexDirection dir, const Bitboard& occupied)
+		{
+			Bitboard ret = ray(index, dir);
+			Bitboard blockers = ret & occupied;
+
+			if(blockers.any())
+			{
+				std::size_t nearest = isAscending(dir) ? blockers.first() : blockers.last();
+				ret &= ~ray(nearest, dir);
+			}
+
+			return ret;
+		}
+};
+
+template<int l>
+constexpr typename HexagonTables<l>::Offset HexagonTables<l>::offsets[hexDirectionCount];
+
+template<int l>
+constexpr typename HexagonTables<l>::Data HexagonTables<l>::data;
+
+static_assert(HexagonTables<6>::x(0) == 5 && HexagonTables<6>::y(0) == 0, "");
+static_assert(HexagonTables<6>::step(0, HexDirection::LEFT) == HexagonTables<6>::noTile, "");
+static_assert(HexagonTables<6>::step(0, HexDirection::RIGHT) == 1, "");
+static_assert(HexagonTables<6>::distance(0, 90) == 10, "");
+
+#endif // _HEXAGON_TABLES_HPP_
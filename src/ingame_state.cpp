@@ -19,6 +19,7 @@
 #include <map>
 #include <fea/ui/inputbackend.hpp>
 
+#include "cyvasse_ws_client.hpp"
 #include "mikelepage/rendered_match.hpp"
 
 using namespace cyvmath;
@@ -27,6 +28,9 @@ IngameState::IngameState(fea::InputHandler& inputHandler, fea::Renderer2D& rende
 	: m_input(inputHandler)
 	, m_renderer(renderer)
 	, m_background(renderer.getViewport().getSize())
+	, m_redrawMode(RedrawMode::ON_CHANGE)
+	, m_redraw(true)
+	, m_frameRendered(false)
 {
 }
 
@@ -52,21 +56,53 @@ std::string IngameState::run()
 				onMouseMoved(event.mouseMove);
 				break;
 			case fea::Event::MOUSEBUTTONPRESSED:
+				CyvasseWSClient::instance().setInputTime(netTime());
 				onMouseButtonPressed(event.mouseButton);
 				break;
 			case fea::Event::MOUSEBUTTONRELEASED:
+				CyvasseWSClient::instance().setInputTime(netTime());
 				onMouseButtonReleased(event.mouseButton);
 				break;
 			case fea::Event::KEYPRESSED:
+				CyvasseWSClient::instance().setInputTime(netTime());
 				onKeyPressed(event.key);
 				break;
 			case fea::Event::KEYRELEASED:
 				onKeyReleased(event.key);
 				break;
+			case fea::Event::RESIZED:
+			{
+				glm::uvec2 size(event.size.width, event.size.height);
+
+				m_renderer.setViewport(fea::Viewport(size, {0, 0}, fea::Camera(glm::vec2(size) / 2.0f)));
+				m_background.setSize(size);
+
+				onResized(event.size);
+				requestRedraw();
+				break;
+			}
+			case fea::Event::GAINEDFOCUS:
+				// the window content may have been
+				// overdrawn while it was in background
+				requestRedraw();
+				break;
 			default: { } // disable compiler warning
 		}
 	}
 
+	// handle everything the server sent since the last frame,
+	// the handlers request a redraw when something changed
+	CyvasseWSClient::instance().poll();
+
+	m_frameRendered = m_redraw || m_redrawMode == RedrawMode::ALWAYS;
+
+	// nothing changed since the last frame,
+	// so the last frame can just stay visible
+	if(!m_frameRendered)
+		return std::string();
+
+	m_redraw = false;
+
 	// after events were processed
 	// * clear the rendered content from the last frame
 	m_renderer.clear();
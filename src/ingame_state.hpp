@@ -25,6 +25,12 @@
 #include <fea/rendering/renderer2d.hpp>
 #include <fea/ui/inputhandler.hpp>
 
+enum class RedrawMode
+{
+	ALWAYS,   // render every frame
+	ON_CHANGE // only render when requestRedraw() was called
+};
+
 class IngameState : public fea::GameState
 {
 	private:
@@ -33,6 +39,10 @@ class IngameState : public fea::GameState
 
 		fea::Quad m_background;
 
+		RedrawMode m_redrawMode;
+		bool m_redraw;
+		bool m_frameRendered;
+
 	public:
 		IngameState(fea::InputHandler&, fea::Renderer2D&);
 
@@ -42,11 +52,24 @@ class IngameState : public fea::GameState
 
 		std::function<void()> tick;
 
+		void setRedrawMode(RedrawMode mode)
+		{ m_redrawMode = mode; }
+
+		// marks the scene as changed, so it is rendered again
+		void requestRedraw()
+		{ m_redraw = true; }
+
+		// whether the last call to run() rendered a new frame
+		bool frameRendered() const
+		{ return m_frameRendered; }
+
 		std::function<void(const fea::Event::MouseMoveEvent&)> onMouseMoved;
 		std::function<void(const fea::Event::MouseButtonEvent&)> onMouseButtonPressed;
 		std::function<void(const fea::Event::MouseButtonEvent&)> onMouseButtonReleased;
 		std::function<void(const fea::Event::KeyEvent&)> onKeyPressed;
 		std::function<void(const fea::Event::KeyEvent&)> onKeyReleased;
+		// called after the viewport was adjusted to the new window size
+		std::function<void(const fea::Event::ResizeEvent&)> onResized;
 
 		void setup() override;
 		std::string run() override;
@@ -34,7 +34,7 @@ extern "C"
 }
 #endif
 
-int main()
+int main(int argc, char** argv)
 {
 #ifndef __EMSCRIPTEN__
 #ifdef HAVE_SIGACTION
@@ -73,7 +73,7 @@ int main()
 		// instantiate the game class
 		app = new CyvasseApp();
 		// start the main loop
-		app->run();
+		app->run(argc, argv);
 	}
 	catch(std::exception& e)
 	{
@@ -0,0 +1,133 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bitboard_position.hpp"
+
+using namespace cyvmath;
+
+namespace mikelepage
+{
+	using cyvmath::mikelepage::CoordinateSet;
+	using cyvmath::mikelepage::PieceMap;
+	using cyvmath::mikelepage::TerrainType;
+
+	BitboardPosition::BitboardPosition()
+		: m_activePlayer{PlayersColor::WHITE}
+	{ }
+
+	Bitboard BitboardPosition::fromCoordinates(const CoordinateSet& coords)
+	{
+		Bitboard ret;
+
+		for(const auto& coord : coords)
+			ret.set(Index::index(coord));
+
+		return ret;
+	}
+
+	PieceType BitboardPosition::pieceAt(std::size_t index) const
+	{
+		if(!occupied().test(index))
+			return PieceType::UNDEFINED;
+
+		for(std::size_t i = 1; i < pieceTypeCount; i++)
+		{
+			if(m_pieceTypes[i].test(index))
+				return static_cast<PieceType>(i);
+		}
+
+		assert(0);
+		return PieceType::UNDEFINED;
+	}
+
+	PlayersColor BitboardPosition::colorAt(std::size_t index) const
+	{
+		if(m_colors[0].test(index))
+			return PlayersColor::WHITE;
+		if(m_colors[1].test(index))
+			return PlayersColor::BLACK;
+
+		return PlayersColor::UNDEFINED;
+	}
+
+	void BitboardPosition::addPiece(PlayersColor color, PieceType type, std::size_t index)
+	{
+		assert(type != PieceType::UNDEFINED);
+		assert(!occupied().test(index));
+
+		m_colors[colorIndex(color)].set(index);
+		m_pieceTypes[static_cast<std::size_t>(type)].set(index);
+	}
+
+	void BitboardPosition::removePiece(std::size_t index)
+	{
+		// the piece is removed from all masks, which
+		// is cheaper than looking up its type first
+		Bitboard mask = ~Bitboard::bit(index);
+
+		for(auto& bb : m_colors)
+			bb &= mask;
+		for(auto& bb : m_pieceTypes)
+			bb &= mask;
+	}
+
+	void BitboardPosition::setTerrain(TerrainType type, std::size_t index)
+	{
+		Bitboard mask = ~Bitboard::bit(index);
+
+		for(auto& bb : m_terrain)
+			bb &= mask;
+
+		if(type != TerrainType::UNDEFINED)
+			m_terrain[static_cast<std::size_t>(type)].set(index);
+	}
+
+	void BitboardPosition::setFortress(PlayersColor color, std::size_t index)
+	{
+		m_fortresses[colorIndex(color)] = Bitboard::bit(index);
+	}
+
+	void BitboardPosition::setFortressRuined(PlayersColor color)
+	{
+		m_fortresses[colorIndex(color)] = Bitboard();
+	}
+
+	PieceMap BitboardPosition::getPieceMap(PlayersColor color) const
+	{
+		PieceMap ret;
+
+		for(std::size_t i = 1; i < pieceTypeCount; i++)
+		{
+			Bitboard bb = m_pieceTypes[i] & pieces(color);
+			if(bb.none())
+				continue;
+
+			auto& coords = ret[static_cast<PieceType>(i)];
+			bb.forEach([&](std::size_t index) {
+				coords.push_back(Tables::coordinate(index));
+			});
+		}
+
+		return ret;
+	}
+
+	bool BitboardPosition::operator==(const BitboardPosition& o) const
+	{
+		// the targets follow from the rest
+		return m_colors == o.m_colors && m_pieceTypes == o.m_pieceTypes && m_terrain == o.m_terrain &&
+		       m_fortresses == o.m_fortresses && m_activePlayer == o.m_activePlayer;
+	}
+}
@@ -0,0 +1,139 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _MIKELEPAGE_BITBOARD_POSITION_HPP_
+#define _MIKELEPAGE_BITBOARD_POSITION_HPP_
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cyvmath/piece_type.hpp>
+#include <cyvmath/players_color.hpp>
+#include <cyvmath/mikelepage/piece.hpp>
+#include <cyvmath/mikelepage/player.hpp>
+#include <cyvmath/mikelepage/terrain.hpp>
+#include "bitboard.hpp"
+#include "hexagon_index.hpp"
+#include "hexagon_tables.hpp"
+
+namespace mikelepage
+{
+	const std::size_t pieceTypeCount = static_cast<std::size_t>(cyvmath::PieceType::KING) + 1;
+	const std::size_t terrainTypeCount = static_cast<std::size_t>(cyvmath::mikelepage::TerrainType::GRASSLAND) + 1;
+
+	/* The contents of the board of a match, stored as one bitboard per
+	 * color, piece type and terrain type. Questions like "which tiles are
+	 * occupied by black rabble" or "how many pieces does white have left"
+	 * are answered with a few AND / OR / popcount operations.
+	 *
+	 * A position is created from a match by HeadlessMatch::getPosition()
+	 * and can be loaded into one with HeadlessMatch::setPosition().
+	 */
+	class BitboardPosition
+	{
+		public:
+			typedef HexagonIndex<6> Index;
+			typedef HexagonTables<6> Tables;
+
+			static constexpr Bitboard allTiles()
+			{ return Bitboard::range(Index::tileCount); }
+
+		private:
+			std::array<Bitboard, 2> m_colors;
+			std::array<Bitboard, pieceTypeCount> m_pieceTypes;
+			std::array<Bitboard, terrainTypeCount> m_terrain;
+
+			// the tile of the fortress of each player,
+			// empty when the fortress is ruined or not placed yet
+			std::array<Bitboard, 2> m_fortresses;
+
+			// all tiles the pieces of each color can move to
+			std::array<Bitboard, 2> m_targets;
+
+			cyvmath::PlayersColor m_activePlayer;
+
+			static std::size_t colorIndex(cyvmath::PlayersColor color)
+			{
+				assert(color == cyvmath::PlayersColor::WHITE || color == cyvmath::PlayersColor::BLACK);
+				return color == cyvmath::PlayersColor::WHITE ? 0 : 1;
+			}
+
+		public:
+			BitboardPosition();
+
+			static Bitboard fromCoordinates(const cyvmath::mikelepage::CoordinateSet&);
+
+			cyvmath::PlayersColor getActivePlayer() const
+			{ return m_activePlayer; }
+
+			void setActivePlayer(cyvmath::PlayersColor color)
+			{ m_activePlayer = color; }
+
+			Bitboard occupied() const
+			{ return m_colors[0] | m_colors[1]; }
+
+			Bitboard pieces(cyvmath::PlayersColor color) const
+			{ return m_colors[colorIndex(color)]; }
+
+			Bitboard pieces(cyvmath::PieceType type) const
+			{ return m_pieceTypes[static_cast<std::size_t>(type)]; }
+
+			Bitboard pieces(cyvmath::PlayersColor color, cyvmath::PieceType type) const
+			{ return pieces(color) & pieces(type); }
+
+			Bitboard terrain(cyvmath::mikelepage::TerrainType type) const
+			{ return m_terrain[static_cast<std::size_t>(type)]; }
+
+			Bitboard fortress(cyvmath::PlayersColor color) const
+			{ return m_fortresses[colorIndex(color)]; }
+
+			Bitboard targets(cyvmath::PlayersColor color) const
+			{ return m_targets[colorIndex(color)]; }
+
+			// the tiles a piece on index could move to along dir, up to and
+			// including the first occupied tile, for pieces moving in lines
+			Bitboard slide(std::size_t index, HexDirection dir) const
+			{ return Tables::slide(index, dir, occupied()); }
+
+			// the pieces of color the other player can capture
+			Bitboard threatened(cyvmath::PlayersColor color) const
+			{ return pieces(color) & targets(!color); }
+
+			// UNDEFINED if the tile is empty
+			cyvmath::PieceType pieceAt(std::size_t index) const;
+			cyvmath::PlayersColor colorAt(std::size_t index) const;
+
+			void addPiece(cyvmath::PlayersColor, cyvmath::PieceType, std::size_t index);
+			void removePiece(std::size_t index);
+
+			void setTerrain(cyvmath::mikelepage::TerrainType, std::size_t index);
+			void setFortress(cyvmath::PlayersColor, std::size_t index);
+			void setFortressRuined(cyvmath::PlayersColor);
+
+			void setTargets(cyvmath::PlayersColor color, const Bitboard& targets)
+			{ m_targets[colorIndex(color)] = targets; }
+
+			// the pieces of one player, in the format of an opening array
+			cyvmath::mikelepage::PieceMap getPieceMap(cyvmath::PlayersColor) const;
+
+			bool operator==(const BitboardPosition&) const;
+
+			bool operator!=(const BitboardPosition& o) const
+			{ return !(*this == o); }
+	};
+}
+
+#endif // _MIKELEPAGE_BITBOARD_POSITION_HPP_
@@ -0,0 +1,321 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "headless_match.hpp"
+
+#include <cassert>
+#include <map>
+#include <stdexcept>
+#include <cyvmath/mikelepage/fortress.hpp>
+#include <cyvmath/mikelepage/player.hpp>
+#include <cyvmath/mikelepage/terrain.hpp>
+#include "promotion.hpp"
+
+using namespace std;
+using namespace cyvmath;
+
+namespace mikelepage
+{
+	using cyvmath::mikelepage::Fortress;
+	using cyvmath::mikelepage::Piece;
+	using cyvmath::mikelepage::PieceMap;
+	using cyvmath::mikelepage::Terrain;
+	using cyvmath::mikelepage::TerrainType;
+
+	class HeadlessPlayer : public cyvmath::mikelepage::Player
+	{
+		private:
+			bool m_setupComplete = false;
+
+		public:
+			HeadlessPlayer(PlayersColor color, HeadlessMatch& match)
+				: Player(match, color, nullptr)
+			{ }
+
+			bool setupComplete() const final override
+			{ return m_setupComplete; }
+
+			void setSetupComplete()
+			{ m_setupComplete = true; }
+
+			bool kingTaken() const
+			{ return m_kingTaken; }
+
+			void setKingTaken(bool taken)
+			{ m_kingTaken = taken; }
+
+			// there is none before the opening array was set
+			bool hasFortress() const
+			{ return static_cast<bool>(m_fortress); }
+	};
+
+	// the number of pieces of each type in an opening array
+	static const map<PieceType, int> armyPieceCounts {
+		{PieceType::MOUNTAINS,   6},
+		{PieceType::RABBLE,      6},
+		{PieceType::CROSSBOWS,   2},
+		{PieceType::SPEARS,      2},
+		{PieceType::LIGHT_HORSE, 2},
+		{PieceType::TREBUCHET,   2},
+		{PieceType::ELEPHANT,    2},
+		{PieceType::HEAVY_HORSE, 2},
+		{PieceType::DRAGON,      1},
+		{PieceType::KING,        1}
+	};
+
+	static Match::playerArray createPlayerArray(HeadlessMatch& match)
+	{
+		return {{
+			make_unique<HeadlessPlayer>(PlayersColor::WHITE, match),
+			make_unique<HeadlessPlayer>(PlayersColor::BLACK, match)
+		}};
+	}
+
+	HeadlessMatch::HeadlessMatch()
+		: cyvmath::mikelepage::Match({}, false, false, createPlayerArray(*this))
+		, m_gameEnded{false}
+		, m_winner{PlayersColor::UNDEFINED}
+	{ }
+
+	void HeadlessMatch::setOpeningArray(PlayersColor color, const PieceMap& pieces)
+	{
+		if (!m_setup)
+			throw runtime_error("setOpeningArray() called after the setup");
+
+		auto& player = dynamic_cast<HeadlessPlayer&>(*m_players[color]);
+		if (player.setupComplete())
+			throw runtime_error("the opening array of " + PlayersColorToStr(color) + " was already set");
+
+		player.evalOpeningArray(pieces);
+
+		auto king = pieces.find(PieceType::KING);
+		if (king == pieces.end() || king->second.size() != 1)
+			throw runtime_error("the opening array of " + PlayersColorToStr(color) + " has no king");
+
+		// the fortress starts below the king
+		player.setFortress(make_unique<Fortress>(color, king->second.front()));
+
+		for (const auto& it : pieces)
+		{
+			for (const auto& coord : it.second)
+				placePiece(make_shared<Piece>(color, it.first, coord, *this));
+		}
+
+		player.setSetupComplete();
+
+		for (auto&& p : m_players)
+			if (!p->setupComplete())
+				return;
+
+		m_setup = false;
+		m_bearingTable.init();
+	}
+
+	void HeadlessMatch::placePiece(shared_ptr<Piece> piece)
+	{
+		auto coord = piece->getCoord();
+		assert(coord);
+
+		m_activePieces.emplace(*coord, piece);
+
+		TerrainType tType = piece->getSetupTerrain();
+
+		if (tType != TerrainType::UNDEFINED)
+			m_terrain.emplace(*coord, make_shared<Terrain>(tType, *coord));
+	}
+
+	void HeadlessMatch::getLegalMoves(MoveVec& moves)
+	{
+		if (m_setup || m_gameEnded)
+			return;
+
+		for (const auto& it : m_activePieces)
+		{
+			const auto& piece = it.second;
+			if (piece->getColor() != m_activePlayer)
+				continue;
+
+			HexCoordinate from = *piece->getCoord();
+
+			for (const auto& to : piece->getPossibleTargetTiles())
+				moves.push_back({from, HexCoordinate(to)});
+		}
+	}
+
+	bool HeadlessMatch::doMove(const Move& move)
+	{
+		if (m_setup || m_gameEnded)
+			return false;
+
+		auto piece = getPieceAt(move.from);
+		if (!piece || piece->getColor() != m_activePlayer)
+			return false;
+
+		if (!piece->moveTo(move.to, false))
+			return false;
+
+		m_players[m_activePlayer]->onTurnEnd();
+
+		// the move took the last king
+		if (m_gameEnded)
+			return true;
+
+		m_activePlayer = !m_activePlayer;
+		onTurnBegin();
+
+		return true;
+	}
+
+	void HeadlessMatch::onTurnBegin()
+	{
+		// same as LocalPlayer::onTurnBegin(), with the
+		// user's choice replaced by choosePromotion
+		auto& player = dynamic_cast<HeadlessPlayer&>(*m_players[m_activePlayer]);
+		auto& fortress = player.getFortress();
+
+		if (fortress.isRuined)
+			return;
+
+		auto piece = getPieceAt(fortress.getCoord());
+		if (!piece || piece->getColor() != m_activePlayer)
+			return;
+
+		auto types = promotionOptions(*piece, player.getInactivePieces(), player.kingTaken());
+		if (types.empty())
+			return;
+
+		PieceType promoteToType = *types.begin();
+		if (types.size() > 1 && choosePromotion)
+			promoteToType = choosePromotion(types);
+
+		assert(types.count(promoteToType));
+		piece->promoteTo(promoteToType);
+	}
+
+	BitboardPosition HeadlessMatch::getPosition()
+	{
+		typedef BitboardPosition::Index Index;
+
+		BitboardPosition ret;
+		ret.setActivePlayer(m_activePlayer);
+
+		Bitboard whiteTargets, blackTargets;
+
+		for (const auto& it : m_activePieces)
+		{
+			const auto& piece = it.second;
+			ret.addPiece(piece->getColor(), piece->getType(), Index::index(it.first));
+
+			if (!m_setup)
+			{
+				auto& targets = (piece->getColor() == PlayersColor::WHITE) ? whiteTargets : blackTargets;
+				targets |= BitboardPosition::fromCoordinates(piece->getPossibleTargetTiles());
+			}
+		}
+
+		ret.setTargets(PlayersColor::WHITE, whiteTargets);
+		ret.setTargets(PlayersColor::BLACK, blackTargets);
+
+		for (const auto& it : m_terrain)
+			ret.setTerrain(it.second->getType(), Index::index(it.first));
+
+		for (auto&& p : m_players)
+		{
+			auto& player = dynamic_cast<HeadlessPlayer&>(*p);
+			if (!player.hasFortress())
+				continue;
+
+			auto& fortress = player.getFortress();
+
+			if (fortress.isRuined)
+				ret.setFortressRuined(player.getColor());
+			else
+				ret.setFortress(player.getColor(), Index::index(fortress.getCoord()));
+		}
+
+		return ret;
+	}
+
+	void HeadlessMatch::setPosition(const BitboardPosition& position)
+	{
+		typedef BitboardPosition::Tables Tables;
+
+		m_activePieces.clear();
+		m_terrain.clear();
+
+		for (auto color : {PlayersColor::WHITE, PlayersColor::BLACK})
+		{
+			for (const auto& it : position.getPieceMap(color))
+			{
+				for (const auto& coord : it.second)
+					m_activePieces.emplace(coord, make_shared<Piece>(color, it.first, coord, *this));
+			}
+
+			auto& player = dynamic_cast<HeadlessPlayer&>(*m_players[color]);
+			Bitboard fortress = position.fortress(color);
+
+			if (fortress.any())
+			{
+				player.setFortress(make_unique<Fortress>(color, Tables::coordinate(fortress.first())));
+			}
+			else
+			{
+				// a ruin stays where the fortress was
+				if (!player.hasFortress())
+					throw runtime_error("no place known for the ruined fortress of " + PlayersColorToStr(color));
+
+				if (!player.getFortress().isRuined)
+					player.getFortress().ruined();
+			}
+
+			// pieces of the opening array that aren't on the board were
+			// taken, they decide which promotions are possible
+			auto& inactivePieces = player.getInactivePieces();
+			inactivePieces.clear();
+
+			for (const auto& it : armyPieceCounts)
+			{
+				for (int i = position.pieces(color, it.first).count(); i < it.second; i++)
+					inactivePieces.emplace(it.first, make_shared<Piece>(color, it.first, nullopt, *this));
+			}
+
+			player.setKingTaken(position.pieces(color, PieceType::KING).none());
+			player.setSetupComplete();
+		}
+
+		for (auto type : {TerrainType::HILL, TerrainType::FOREST, TerrainType::GRASSLAND})
+		{
+			position.terrain(type).forEach([&](size_t index) {
+				auto coord = Tables::coordinate(index);
+				m_terrain.emplace(coord, make_shared<Terrain>(type, coord));
+			});
+		}
+
+		m_activePlayer = position.getActivePlayer();
+		m_gameEnded = false;
+		m_winner = PlayersColor::UNDEFINED;
+
+		// the bearing table depends on the pieces on the board
+		m_setup = false;
+		m_bearingTable.init();
+	}
+
+	void HeadlessMatch::endGame(PlayersColor winner)
+	{
+		m_gameEnded = true;
+		m_winner = winner;
+	}
+}
@@ -0,0 +1,100 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _MIKELEPAGE_HEADLESS_MATCH_HPP_
+#define _MIKELEPAGE_HEADLESS_MATCH_HPP_
+
+#include <cyvmath/mikelepage/match.hpp>
+
+#include <functional>
+#include <set>
+#include <vector>
+#include "bitboard_position.hpp"
+
+namespace mikelepage
+{
+	/* A match following the same rules as RenderedMatch, but without any
+	 * rendering, file access or networking. Both players are controlled
+	 * through the public interface, so it can be used for bots, to validate
+	 * recorded games and to simulate lots of matches in one process.
+	 */
+	class HeadlessMatch : public cyvmath::mikelepage::Match
+	{
+		public:
+			struct Move
+			{
+				HexCoordinate from;
+				HexCoordinate to;
+			};
+
+			typedef std::vector<Move> MoveVec;
+
+			// called when a rabble could be promoted to more than one piece
+			// type, the first one of them is chosen if this isn't set
+			std::function<cyvmath::PieceType(const std::set<cyvmath::PieceType>&)> choosePromotion;
+
+		private:
+			bool m_gameEnded;
+			cyvmath::PlayersColor m_winner;
+
+			void placePiece(std::shared_ptr<cyvmath::mikelepage::Piece>);
+			void onTurnBegin();
+
+		public:
+			HeadlessMatch();
+
+			// non-copyable
+			HeadlessMatch(const HeadlessMatch&) = delete;
+			HeadlessMatch& operator=(const HeadlessMatch&) = delete;
+
+			bool gameEnded() const
+			{ return m_gameEnded; }
+
+			cyvmath::PlayersColor getWinner() const
+			{ return m_winner; }
+
+			// puts the opening array of one player onto the board,
+			// the match begins when both players have set theirs
+			void setOpeningArray(cyvmath::PlayersColor, const cyvmath::mikelepage::PieceMap&);
+
+			// appends all moves the active player can do to moves,
+			// so the same vector can be reused for many positions
+			void getLegalMoves(MoveVec& moves);
+
+			MoveVec getLegalMoves()
+			{
+				MoveVec moves;
+				getLegalMoves(moves);
+				return moves;
+			}
+
+			// does the move if it is legal for the active player,
+			// then ends the turn and does pending promotions
+			bool doMove(const Move&);
+
+			// the board contents and the possible target tiles of all pieces
+			BitboardPosition getPosition();
+
+			// replaces the board contents, leaving the setup if necessary.
+			// The pieces of the opening arrays that aren't on the board
+			// become the inactive pieces of the players.
+			void setPosition(const BitboardPosition&);
+
+			void endGame(cyvmath::PlayersColor winner) final override;
+	};
+}
+
+#endif // _MIKELEPAGE_HEADLESS_MATCH_HPP_
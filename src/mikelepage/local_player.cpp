@@ -16,14 +16,12 @@
 
 #include "local_player.hpp"
 
-#include <cyvws/json_game_msg.hpp>
-#include "cyvasse_ws_client.hpp"
 #include "hexagon_board.hpp"
+#include "promotion.hpp"
 #include "rendered_fortress.hpp"
 #include "rendered_match.hpp"
 
 using namespace cyvmath;
-using namespace cyvws;
 
 namespace mikelepage
 {
@@ -41,54 +39,25 @@ namespace mikelepage
 
 		if(piece && piece->getColor() == m_color && piece->getType() != PieceType::KING)
 		{
-			auto baseTier = piece->getBaseTier();
-			PieceType pieceType = piece->getType();
 			PieceType promoteToType = PieceType::UNDEFINED;
 
-			if(baseTier == 3)
-			{
-				if(m_kingTaken)
-					promoteToType = PieceType::KING;
-			}
-			else if(baseTier == 2)
-			{
-				static const std::map<PieceType, PieceType> nextTierPieces {
-					{PieceType::CROSSBOWS, PieceType::TREBUCHET},
-					{PieceType::SPEARS, PieceType::ELEPHANT},
-					{PieceType::LIGHT_HORSE, PieceType::HEAVY_HORSE}
-				};
+			auto availablePieceTypes = promotionOptions(*piece, m_inactivePieces, m_kingTaken);
 
-				if(m_inactivePieces.count(nextTierPieces.at(pieceType)) > 0)
-					promoteToType = nextTierPieces.at(pieceType);
-			}
-			else if(pieceType == PieceType::RABBLE) // can only promote rabble, not the king
+			switch(availablePieceTypes.size())
 			{
-				std::set<PieceType> availablePieceTypes;
-
-				for(PieceType type : {PieceType::CROSSBOWS, PieceType::SPEARS, PieceType::LIGHT_HORSE})
-				{
-					if(m_inactivePieces.count(type) > 0)
-						availablePieceTypes.insert(type);
-				}
-
-				switch(availablePieceTypes.size())
-				{
-					case 0:
-						break;
-					case 1:
-						promoteToType = *availablePieceTypes.begin();
-						break;
-					default:
-						m_match.showPromotionPieces(availablePieceTypes);
-						break;
-				}
+				case 0:
+					break;
+				case 1:
+					promoteToType = *availablePieceTypes.begin();
+					break;
+				default:
+					// only possible for rabble, let the user choose
+					m_match.showPromotionPieces(availablePieceTypes);
+					break;
 			}
 
 			if(promoteToType != PieceType::UNDEFINED)
-			{
-				piece->promoteTo(promoteToType);
-				CyvasseWSClient::instance().send(json::gameMsgPromote(pieceType, promoteToType));
-			}
+				m_match.promote(piece, promoteToType);
 		}
 	}
 }
@@ -0,0 +1,60 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "promotion.hpp"
+
+using namespace cyvmath;
+
+namespace mikelepage
+{
+	std::set<PieceType> promotionOptions(const cyvmath::mikelepage::Piece& piece, const InactivePieceMap& inactivePieces, bool kingTaken)
+	{
+		std::set<PieceType> ret;
+
+		PieceType pieceType = piece.getType();
+		auto baseTier = piece.getBaseTier();
+
+		if(pieceType == PieceType::KING)
+			return ret;
+
+		if(baseTier == 3)
+		{
+			if(kingTaken)
+				ret.insert(PieceType::KING);
+		}
+		else if(baseTier == 2)
+		{
+			static const std::map<PieceType, PieceType> nextTierPieces {
+				{PieceType::CROSSBOWS, PieceType::TREBUCHET},
+				{PieceType::SPEARS, PieceType::ELEPHANT},
+				{PieceType::LIGHT_HORSE, PieceType::HEAVY_HORSE}
+			};
+
+			if(inactivePieces.count(nextTierPieces.at(pieceType)) > 0)
+				ret.insert(nextTierPieces.at(pieceType));
+		}
+		else if(pieceType == PieceType::RABBLE)
+		{
+			for(PieceType type : {PieceType::CROSSBOWS, PieceType::SPEARS, PieceType::LIGHT_HORSE})
+			{
+				if(inactivePieces.count(type) > 0)
+					ret.insert(type);
+			}
+		}
+
+		return ret;
+	}
+}
@@ -0,0 +1,35 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _MIKELEPAGE_PROMOTION_HPP_
+#define _MIKELEPAGE_PROMOTION_HPP_
+
+#include <map>
+#include <memory>
+#include <set>
+#include <cyvmath/piece_type.hpp>
+#include <cyvmath/mikelepage/piece.hpp>
+
+namespace mikelepage
+{
+	typedef std::multimap<cyvmath::PieceType, std::shared_ptr<cyvmath::mikelepage::Piece>> InactivePieceMap;
+
+	// the piece types a piece standing on its own fortress can be promoted to,
+	// given the inactive pieces of its player and whether its king was taken
+	std::set<cyvmath::PieceType> promotionOptions(const cyvmath::mikelepage::Piece&, const InactivePieceMap&, bool kingTaken);
+}
+
+#endif // _MIKELEPAGE_PROMOTION_HPP_
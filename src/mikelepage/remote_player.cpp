@@ -24,6 +24,7 @@
 #include <cyvws/msg.hpp>
 #include <cyvws/game_msg.hpp>
 #include <cyvws/json_game_msg.hpp>
+#include "binary_game_msg.hpp"
 #include "cyvasse_ws_client.hpp"
 #include "rendered_fortress.hpp"
 #include "rendered_match.hpp"
@@ -31,6 +32,7 @@
 
 using namespace std;
 using std::placeholders::_1;
+using std::placeholders::_2;
 
 using namespace cyvmath;
 using namespace cyvmath::mikelepage;
@@ -44,154 +46,234 @@ namespace mikelepage
 		: Player(match, color, move(fortress) /*, id */) // TODO
 		, m_match(match) // should probably be considered a workaround
 	{
-		CyvasseWSClient::instance().handleMessage = bind(&RemotePlayer::handleMessage, this, _1);
+		setupHandlers();
+
+		auto& client = CyvasseWSClient::instance();
+
+		client.handleMessage = bind(&RemotePlayer::handleMessage, this, _1);
+		client.handleBinaryMessage = bind(&RemotePlayer::handleBinaryMessage, this, _1, _2);
+		client.sendHello();
 	}
 
-	void RemotePlayer::handleMessage(Json::Value msg)
+	void RemotePlayer::setupHandlers()
 	{
-		// TODO: Revise when multiplayer for the native game is implemented
-		if (msg[MSG_TYPE].asString() != MsgType::GAME_MSG)
-			throw runtime_error("this message should be handled outside the game (message type "
-				+ msg[MSG_TYPE].asString() + ")");
+		using gamemsg::Action;
+
+		m_jsonHandlers.set(Action::SET_OPENING_ARRAY, [this](const Json::Value& param) { onOpeningArray(json::pieceMap(param)); });
+		m_jsonHandlers.set(Action::SET_IS_READY,      [](const Json::Value&) { });
+		m_jsonHandlers.set(Action::MOVE,              [this](const Json::Value& param) { onMove(json::movement(param)); });
+		m_jsonHandlers.set(Action::MOVE_CAPTURE,      [this](const Json::Value& param) { onMoveCapture(json::moveCapture(param)); });
+		m_jsonHandlers.set(Action::PROMOTE,           [this](const Json::Value& param) { onPromotion(json::promotion(param)); });
+		m_jsonHandlers.set(Action::RESIGN,            [this](const Json::Value&) { onResign(); });
+
+		m_binaryHandlers.set(Action::SET_OPENING_ARRAY, [this](const string& msg) { onOpeningArray(binary::pieceMap(msg)); });
+		m_binaryHandlers.set(Action::SET_IS_READY,      [](const string&) { });
+		m_binaryHandlers.set(Action::MOVE,              [this](const string& msg) { onMove(binary::movement(msg)); });
+		m_binaryHandlers.set(Action::MOVE_CAPTURE,      [this](const string& msg) { onMoveCapture(binary::moveCapture(msg)); });
+		m_binaryHandlers.set(Action::PROMOTE,           [this](const string& msg) { onPromotion(binary::promotion(msg)); });
+		m_binaryHandlers.set(Action::RESIGN,            [this](const string&) { onResign(); });
+	}
 
-		const auto& msgData = msg[MSG_DATA];
-		const auto& param = msgData[PARAM];
+	void RemotePlayer::confirm(uint32_t seq, bool valid)
+	{
+		auto& client = CyvasseWSClient::instance();
 
-		const auto& action = msgData[ACTION].asString();
+		// remote ends that don't know the binary
+		// format don't expect a confirmation
+		if (client.useBinary())
+			client.sendBinary(valid ? binary::gameMsgAck(seq) : binary::gameMsgReject(seq));
+	}
 
-		if (action == GameMsgAction::SET_OPENING_ARRAY)
-		{
-			const auto& pieces = json::pieceMap(param);
-			evalOpeningArray(pieces);
+	void RemotePlayer::onOpeningArray(const PieceMap& pieces)
+	{
+		evalOpeningArray(pieces);
 
-			for (const auto& it : pieces)
+		for (const auto& it : pieces)
+		{
+			for (const auto& coord : it.second)
 			{
-				for (const auto& coord : it.second)
-				{
-					// TODO: Move this somewhere else (probably cyvmath)
-					if (it.first == PieceType::KING)
-						m_fortress->setCoord(coord);
-
-					m_pieceCache.push_back(make_shared<RenderedPiece>(it.first, coord, m_color, m_match));
-				}
-			}
+				// TODO: Move this somewhere else (probably cyvmath)
+				if (it.first == PieceType::KING)
+					m_fortress->setCoord(coord);
 
-			m_setupComplete = true;
-			m_match.tryLeaveSetup();
+				m_pieceCache.push_back(make_shared<RenderedPiece>(it.first, coord, m_color, m_match));
+			}
 		}
-		else if (action == GameMsgAction::SET_IS_READY)
-		{ }
-		else if (action == GameMsgAction::MOVE)
-		{
-			auto movement = json::movement(param);
 
-			if (movement.pieceType == PieceType::UNDEFINED)
-				throw runtime_error("move of undefined piece " + PieceTypeToStr(movement.pieceType) + " requested");
+		m_setupComplete = true;
+		m_match.tryLeaveSetup();
+	}
 
-			auto it = m_match.getActivePieces().find(movement.oldPos);
-			if (it == m_match.getActivePieces().end())
-				throw runtime_error("move of non-existent piece at " + movement.oldPos.toString() + " requested");
+	void RemotePlayer::onMove(const Movement& movement)
+	{
+		if (movement.pieceType == PieceType::UNDEFINED)
+			throw runtime_error("move of undefined piece " + PieceTypeToStr(movement.pieceType) + " requested");
 
-			auto piece = it->second;
+		auto it = m_match.getActivePieces().find(movement.oldPos);
+		if (it == m_match.getActivePieces().end())
+			throw runtime_error("move of non-existent piece at " + movement.oldPos.toString() + " requested");
 
-			if (piece->getType() != movement.pieceType)
-				throw runtime_error(
-					"remote client requested move of " + PieceTypeToStr(movement.pieceType) + ", but there is " +
-					PieceTypeToStr(piece->getType()) + " at " + movement.oldPos.toString()
-				);
+		auto piece = it->second;
 
-			m_match.tryMovePiece(piece, movement.newPos);
-		}
-		else if (action == GameMsgAction::MOVE_CAPTURE)
+		if (piece->getType() != movement.pieceType)
+			throw runtime_error(
+				"remote client requested move of " + PieceTypeToStr(movement.pieceType) + ", but there is " +
+				PieceTypeToStr(piece->getType()) + " at " + movement.oldPos.toString()
+			);
+
+		if (!m_match.tryMovePiece(piece, movement.newPos))
+			throw runtime_error("remote client requested invalid move to " + movement.newPos.toString());
+	}
+
+	void RemotePlayer::onMoveCapture(const MoveCapture& movement)
+	{
+		if (movement.atkPT == PieceType::UNDEFINED)
+			throw runtime_error("move of undefined piece " + PieceTypeToStr(movement.atkPT) + " requested");
+		if (movement.defPT == PieceType::UNDEFINED)
+			throw runtime_error("capture of undefined piece " + PieceTypeToStr(movement.atkPT) + " requested");
+
+		auto it = m_match.getActivePieces().find(movement.oldPos);
+
+		if (it == m_match.getActivePieces().end())
+			throw runtime_error("move of non-existent piece at " + movement.oldPos.toString() + " requested");
+		if (it->second->getType() != movement.atkPT)
+			throw runtime_error(
+				"move of " + PieceTypeToStr(movement.atkPT) + " requested, but there is " +
+				PieceTypeToStr(it->second->getType()) + " at " + movement.oldPos.toString()
+			);
+
+		auto piece = it->second;
+
+		it = m_match.getActivePieces().find(movement.defPiecePos);
+
+		if (it == m_match.getActivePieces().end())
+			throw runtime_error("capture of non-existent piece at " + movement.defPiecePos.toString() + " requested");
+		if (it->second->getType() != movement.defPT)
+			throw runtime_error(
+				"capture of " + PieceTypeToStr(movement.defPT) + " requested, but there is " +
+				PieceTypeToStr(it->second->getType()) + " at " + movement.defPiecePos.toString()
+			);
+
+		if (!m_match.tryMovePiece(piece, movement.newPos))
+			throw runtime_error("remote client requested invalid move to " + movement.newPos.toString());
+	}
+
+	void RemotePlayer::onPromotion(const Promotion& promotion)
+	{
+		if (m_fortress->isRuined)
+			throw runtime_error("requested promotion of a piece although the fortress is ruined");
+
+		auto piece = m_match.getPieceAt(m_fortress->getCoord());
+		if (!piece)
+			throw runtime_error("requested promotion of a piece although there is no piece on the fortress");
+
+		if (piece->getType() != promotion.origType)
+			throw runtime_error("requested promotion of " + PieceTypeToStr(promotion.origType) + ", but there is a "
+				+ PieceTypeToStr(piece->getType()) + " piece in the fortress.");
+
+		switch(promotion.origType)
 		{
-			auto movement = json::moveCapture(param);
+			case PieceType::RABBLE:
+				if (!(promotion.newType == PieceType::CROSSBOWS ||
+					promotion.newType == PieceType::SPEARS ||
+					promotion.newType == PieceType::LIGHT_HORSE))
+					throw runtime_error("requested promotion from rabble to " + PieceTypeToStr(promotion.newType));
+
+				break;
+			case PieceType::CROSSBOWS:
+				if (promotion.newType != PieceType::TREBUCHET)
+					throw runtime_error("requested promotion from crossbows to " + PieceTypeToStr(promotion.newType));
+
+				break;
+			case PieceType::SPEARS:
+				if (promotion.newType != PieceType::ELEPHANT)
+					throw runtime_error("requested promotion from spears to " + PieceTypeToStr(promotion.newType));
+
+				break;
+			case PieceType::LIGHT_HORSE:
+				if (promotion.newType != PieceType::HEAVY_HORSE)
+					throw runtime_error("requested promotion from light horse to " + PieceTypeToStr(promotion.newType));
+
+				break;
+			case PieceType::TREBUCHET:
+			case PieceType::ELEPHANT:
+			case PieceType::HEAVY_HORSE:
+				if (promotion.newType != PieceType::KING)
+					throw runtime_error("requested promotion from " + PieceTypeToStr(promotion.origType) +
+						" to " + PieceTypeToStr(promotion.newType));
+				else if (!m_kingTaken)
+					throw runtime_error("requested promotion to king when there still is a king");
+
+				break;
+			default:
+				throw runtime_error("requested promotion of unknown piece");
+		}
 
-			if (movement.atkPT == PieceType::UNDEFINED)
-				throw runtime_error("move of undefined piece " + PieceTypeToStr(movement.atkPT) + " requested");
-			if (movement.defPT == PieceType::UNDEFINED)
-				throw runtime_error("capture of undefined piece " + PieceTypeToStr(movement.atkPT) + " requested");
+		piece->promoteTo(promotion.newType);
+		m_match.invalidateTargetTiles();
+	}
 
-			auto it = m_match.getActivePieces().find(movement.oldPos);
+	void RemotePlayer::onResign()
+	{
+		m_match.endGame(!m_color);
+	}
 
-			if (it == m_match.getActivePieces().end())
-				throw runtime_error("move of non-existent piece at " + movement.oldPos.toString() + " requested");
-			if (it->second->getType() != movement.atkPT)
-				throw runtime_error(
-					"move of " + PieceTypeToStr(movement.atkPT) + " requested, but there is " +
-					PieceTypeToStr(it->second->getType()) + " at " + movement.oldPos.toString()
-				);
+	// returns a pointer to the string inside of val, to compare
+	// it without copying. Returns "" if val isn't a string.
+	static const char* cStr(const Json::Value& val)
+	{
+		return val.isString() ? val.asCString() : "";
+	}
 
-			auto piece = it->second;
+	void RemotePlayer::handleMessage(const Json::Value& msg)
+	{
+		// msg is const, so none of the lookups
+		// below insert missing members into it
 
-			it = m_match.getActivePieces().find(movement.defPiecePos);
+		// TODO: Revise when multiplayer for the native game is implemented
+		if (cStr(msg[MSG_TYPE]) != MsgType::GAME_MSG)
+			throw runtime_error("this message should be handled outside the game (message type "
+				+ string(cStr(msg[MSG_TYPE])) + ")");
 
-			if (it == m_match.getActivePieces().end())
-				throw runtime_error("capture of non-existent piece at " + movement.defPiecePos.toString() + " requested");
-			if (it->second->getType() != movement.defPT)
-				throw runtime_error(
-					"capture of " + PieceTypeToStr(movement.defPT) + " requested, but there is " +
-					PieceTypeToStr(it->second->getType()) + " at " + movement.defPiecePos.toString()
-				);
+		// every game message changes something visible
+		m_match.requestRedraw();
 
-			m_match.tryMovePiece(piece, movement.newPos);
-		}
-		else if (action == GameMsgAction::PROMOTE)
-		{
-			auto promotion = json::promotion(param);
+		const auto& msgData = msg[MSG_DATA];
 
-			if (m_fortress->isRuined)
-				throw runtime_error("requested promotion of a piece although the fortress is ruined");
+		const char* actionName = cStr(msgData[ACTION]);
+		uint32_t seq = CyvasseWSClient::instance().nextIncomingSeq();
 
-			auto piece = m_match.getPieceAt(m_fortress->getCoord());
-			if (!piece)
-				throw runtime_error("requested promotion of a piece although there is no piece on the fortress");
+		try
+		{
+			auto action = gamemsg::actionFromName(actionName);
+			if (!action)
+				throw runtime_error("got a json request with action set to " + string(actionName));
 
-			if (piece->getType() != promotion.origType)
-				throw runtime_error("requested promotion of " + PieceTypeToStr(promotion.origType) + ", but there is a "
-					+ PieceTypeToStr(piece->getType()) + " piece in the fortress.");
+			m_jsonHandlers.dispatch(*action, msgData[PARAM]);
+		}
+		catch (...)
+		{
+			confirm(seq, false);
+			throw;
+		}
 
-			switch(promotion.origType)
-			{
-				case PieceType::RABBLE:
-					if (!(promotion.newType == PieceType::CROSSBOWS ||
-						promotion.newType == PieceType::SPEARS ||
-						promotion.newType == PieceType::LIGHT_HORSE))
-						throw runtime_error("requested promotion from rabble to " + PieceTypeToStr(promotion.newType));
-
-					break;
-				case PieceType::CROSSBOWS:
-					if (promotion.newType != PieceType::TREBUCHET)
-						throw runtime_error("requested promotion from crossbows to " + PieceTypeToStr(promotion.newType));
-
-					break;
-				case PieceType::SPEARS:
-					if (promotion.newType != PieceType::ELEPHANT)
-						throw runtime_error("requested promotion from spears to " + PieceTypeToStr(promotion.newType));
-
-					break;
-				case PieceType::LIGHT_HORSE:
-					if (promotion.newType != PieceType::HEAVY_HORSE)
-						throw runtime_error("requested promotion from light horse to " + PieceTypeToStr(promotion.newType));
-
-					break;
-				case PieceType::TREBUCHET:
-				case PieceType::ELEPHANT:
-				case PieceType::HEAVY_HORSE:
-					if (promotion.newType != PieceType::KING)
-						throw runtime_error("requested promotion from " + PieceTypeToStr(promotion.origType) +
-							" to " + PieceTypeToStr(promotion.newType));
-					else if (!m_kingTaken)
-						throw runtime_error("requested promotion to king when there still is a king");
-
-					break;
-				default:
-					throw runtime_error("requested promotion of unknown piece");
-			}
+		confirm(seq, true);
+	}
 
-			piece->promoteTo(promotion.newType);
+	void RemotePlayer::handleBinaryMessage(const string& msg, uint32_t seq)
+	{
+		m_match.requestRedraw();
+
+		try
+		{
+			m_binaryHandlers.dispatch(binary::action(msg), msg);
 		}
-		//else if (action == GameMsgAction::RESIGN)
-		else
-			throw runtime_error("got a json request with action set to " + msg[ACTION].asString());
+		catch (...)
+		{
+			confirm(seq, false);
+			throw;
+		}
+
+		confirm(seq, true);
 	}
 }
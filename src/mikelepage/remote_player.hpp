@@ -17,8 +17,11 @@
 #ifndef _MIKELEPAGE_REMOTE_PLAYER_HPP_
 #define _MIKELEPAGE_REMOTE_PLAYER_HPP_
 
+#include <string>
 #include <cyvmath/mikelepage/player.hpp>
+#include <cyvws/game_msg.hpp>
 #include <json/value.h>
+#include "game_msg.hpp"
 #include "rendered_fortress.hpp"
 #include "hexagon_board.hpp"
 
@@ -33,6 +36,7 @@ namespace mikelepage
 
 	class RemotePlayer : public cyvmath::mikelepage::Player
 	{
+		friend RenderedMatch;
 		private:
 			bool m_setupComplete = false;
 
@@ -42,6 +46,25 @@ namespace mikelepage
 
 			RenderedMatch& m_match;
 
+			// the handlers decode the message parameters
+			// and pass them to the functions below
+			gamemsg::Dispatcher<const Json::Value&> m_jsonHandlers;
+			gamemsg::Dispatcher<const std::string&> m_binaryHandlers;
+
+			void setupHandlers();
+
+			// tells the remote end whether the game message
+			// with the sequence number seq was valid
+			void confirm(uint32_t seq, bool valid);
+
+			// handlers for the individual game messages,
+			// independent of the format they were sent in
+			void onOpeningArray(const cyvmath::mikelepage::PieceMap&);
+			void onMove(const cyvws::Movement&);
+			void onMoveCapture(const cyvws::MoveCapture&);
+			void onPromotion(const cyvws::Promotion&);
+			void onResign();
+
 		public:
 			RemotePlayer(PlayersColor, RenderedMatch&, std::unique_ptr<RenderedFortress> = {});
 			virtual ~RemotePlayer() = default;
@@ -55,7 +78,8 @@ namespace mikelepage
 			void clearPieceCache()
 			{ m_pieceCache.clear(); }
 
-			void handleMessage(Json::Value);
+			void handleMessage(const Json::Value&);
+			void handleBinaryMessage(const std::string&, uint32_t seq);
 	};
 }
 
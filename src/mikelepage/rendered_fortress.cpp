@@ -18,7 +18,7 @@
 
 #include <array>
 #include "hexagon_board.hpp"
-#include "texturemaker.hpp" // lodepng helper function
+#include "texture_atlas.hpp"
 
 using namespace std;
 using namespace cyvmath;
@@ -32,22 +32,23 @@ namespace mikelepage
 		assert(color != PlayersColor::UNDEFINED);
 
 		string texturePath = "res/icons/" + string(PlayersColorToStr(color)) + "/fortress.png";
-		m_texture = makeTexture(texturePath).first;
-		m_quad.setTexture(m_texture);
+		TextureAtlas::instance().apply(m_quad, texturePath);
 
-		glm::vec2 tileSize = board.getTileSize();
-		glm::vec2 tilePos = board.getTilePosition(coord);
-
-		m_quad.setSize({tileSize.x, tileSize.y});
-		m_quad.setPosition({tilePos.x, tilePos.y});
+		m_quad.setSize(board.getTileSize());
+		m_quad.setPosition(board.getTilePosition(coord));
 	}
 
 	void RenderedFortress::setCoord(Coordinate coord)
 	{
 		m_coord = coord;
 
-		glm::vec2 tilePos = m_board.getTilePosition(coord);
-		m_quad.setPosition({tilePos.x, tilePos.y});
+		m_quad.setPosition(m_board.getTilePosition(coord));
+	}
+
+	void RenderedFortress::updateLayout()
+	{
+		m_quad.setSize(m_board.getTileSize());
+		m_quad.setPosition(m_board.getTilePosition(m_coord));
 	}
 
 	void RenderedFortress::ruined()
@@ -55,6 +56,14 @@ namespace mikelepage
 		Fortress::ruined();
 
 		string texturePath = "res/icons/" + string(PlayersColorToStr(m_color)) + "/fortress_ruined.png";
-		m_texture = makeTexture(texturePath).first;
+		TextureAtlas::instance().apply(m_quad, texturePath);
+	}
+
+	void RenderedFortress::repaired()
+	{
+		isRuined = false;
+
+		string texturePath = "res/icons/" + string(PlayersColorToStr(m_color)) + "/fortress.png";
+		TextureAtlas::instance().apply(m_quad, texturePath);
 	}
 }
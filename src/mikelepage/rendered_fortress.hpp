@@ -18,7 +18,7 @@
 #define _MIKELEPAGE_RENDERED_FORTRESS_HPP_
 
 #include <cyvmath/mikelepage/fortress.hpp>
-#include <fea/rendering/quad.hpp>
+#include <fea/rendering/animatedquad.hpp>
 
 template<int> class HexagonBoard;
 
@@ -29,8 +29,7 @@ namespace mikelepage
 		private:
 			HexagonBoard<6>& m_board;
 
-			fea::Quad m_quad;
-			fea::Texture m_texture;
+			fea::AnimatedQuad m_quad;
 
 		public:
 			RenderedFortress(cyvmath::PlayersColor, cyvmath::Coordinate, HexagonBoard<6>&);
@@ -38,9 +37,15 @@ namespace mikelepage
 			fea::Quad* getQuad()
 			{ return &m_quad; }
 
+			// updates size and position of the quad
+			// after the layout of the board changed
+			void updateLayout();
+
 			void setCoord(cyvmath::Coordinate) final override;
 
 			void ruined() final override;
+			// reverts ruined(), only for undoing moves
+			void repaired();
 	};
 }
 
@@ -16,7 +16,6 @@
 
 #include "rendered_match.hpp"
 
-#include <algorithm>
 #include <fstream>
 #include <stdexcept>
 #ifdef __EMSCRIPTEN__
@@ -24,9 +23,9 @@
 #endif
 #include <json/reader.h>
 #include <cyvws/json_game_msg.hpp>
-#include <texturemaker.hpp> // lodepng helper function
 #include "common.hpp"
 #include "cyvasse_ws_client.hpp"
+#include "game_msg.hpp"
 #include "hexagon_board.hpp"
 #include "ingame_state.hpp"
 #include "local_player.hpp"
@@ -34,6 +33,7 @@
 #include "rendered_piece.hpp"
 #include "rendered_terrain.hpp"
 #include "remote_player.hpp"
+#include "texture_atlas.hpp"
 
 using namespace std;
 using namespace std::placeholders;
@@ -69,11 +69,14 @@ namespace mikelepage
 		, m_self{dynamic_cast<LocalPlayer&>(*m_players[m_ownColor])}
 		, m_op{dynamic_cast<RemotePlayer&>(*m_players[m_opColor])}
 		, m_setupAccepted{false}
+		, m_resignRequested{false}
 		, m_piecePromotionBackground{{glm::vec2{100, 100}, glm::vec2{100, 100}, glm::vec2{100, 100}}}
 		, m_piecePromotionTypes{{PieceType::UNDEFINED, PieceType::UNDEFINED, PieceType::UNDEFINED}}
 		, m_renderPiecePromotionBgs{0}
 		, m_piecePromotionHover{0}
 		, m_piecePromotionMousePress{0}
+		, m_deferEndGame{false}
+		, m_deferredWinner{PlayersColor::UNDEFINED}
 	{
 		// hardcoded temporarily [TODO]
 		static const map<PlayersColor, Coordinate> fortressStartCoords {
@@ -82,20 +85,16 @@ namespace mikelepage
 		};
 
 		auto ownFortress = make_unique<RenderedFortress>(m_ownColor, fortressStartCoords.at(m_ownColor), m_board);
-		m_renderedEntities[RenderPriority::FORTRESS].push_back(ownFortress->getQuad());
+		getRenderLayer(RenderPriority::FORTRESS).add(ownFortress->getQuad());
 
 		m_self.setFortress(move(ownFortress));
 		m_op.setFortress(make_unique<RenderedFortress>(m_opColor, fortressStartCoords.at(m_opColor), m_board));
 
-		glm::uvec2 boardSize = m_board.getSize();
-		glm::uvec2 boardPos = m_board.getPosition();
-
-		auto tmpTexture = makeTexture("res/setup-done.png");
+		const auto& atlas = TextureAtlas::instance();
 
-		m_buttonSetupDoneTexture = move(tmpTexture.first);
-		m_buttonSetupDone.setPosition(boardPos + boardSize - tmpTexture.second);
-		m_buttonSetupDone.setSize(tmpTexture.second); // hardcoded for now, can be done properly somewhen else
-		m_buttonSetupDone.setTexture(m_buttonSetupDoneTexture);
+		m_buttonSetupDone.setSize(atlas.getImageSize("res/setup-done.png")); // hardcoded for now, can be done properly somewhen else
+		atlas.apply(m_buttonSetupDone, "res/setup-done.png");
+		positionSetupDoneButton();
 
 		for (auto& quad : m_piecePromotionBackground)
 			quad.setColor({95, 95, 95});
@@ -106,13 +105,18 @@ namespace mikelepage
 		ingameState.onMouseMoved          = bind(&Board::onMouseMoved, &m_board, _1);
 		ingameState.onMouseButtonPressed  = bind(&Board::onMouseButtonPressed, &m_board, _1);
 		ingameState.onMouseButtonReleased = bind(&Board::onMouseButtonReleased, &m_board, _1);
-		ingameState.onKeyPressed          = [](const fea::Event::KeyEvent&) { };
+		ingameState.onKeyPressed          = bind(&RenderedMatch::onKeyPressed, this, _1);
 		ingameState.onKeyReleased         = [](const fea::Event::KeyEvent&) { };
+		ingameState.onResized             = bind(&RenderedMatch::onResized, this, _1);
 
 		m_board.onTileMouseOver    = bind(&RenderedMatch::onTileMouseOver, this, _1);
 		m_board.onTileClicked      = bind(&RenderedMatch::onTileClicked, this, _1);
 		m_board.onMouseMoveOutside = bind(&RenderedMatch::onMouseMoveOutside, this, _1);
 		m_board.onClickedOutside   = bind(&RenderedMatch::onClickedOutsideBoard, this, _1);
+		m_board.onChanged          = bind(&IngameState::requestRedraw, &ingameState);
+
+		CyvasseWSClient::instance().onAck    = bind(&RenderedMatch::onMovesConfirmed, this, _1);
+		CyvasseWSClient::instance().onReject = bind(&RenderedMatch::onMoveRejected, this, _1);
 
 		setStatus("Setup");
 	}
@@ -128,15 +132,22 @@ namespace mikelepage
 				Module.setStatus(Module.Pointer_stringify($0));
 			}, text.c_str());
 			#endif
+
+			requestRedraw();
 		}
 	}
 
+	void RenderedMatch::requestRedraw()
+	{
+		m_ingameState.requestRedraw();
+	}
+
 	void RenderedMatch::tick()
 	{
 		m_board.tick();
 
-		for (auto&& entityVecIt : m_renderedEntities)
-			for (auto&& it : entityVecIt.second)
+		for (auto&& layer : m_renderLayers)
+			for (auto&& it : layer)
 				m_renderer.queue(*it);
 
 		// Move the logic bit to the backend
@@ -221,22 +232,44 @@ namespace mikelepage
 			{
 				auto oldCoord = *m_selectedPiece->getCoord();
 
-				if (tryMovePiece(m_selectedPiece, coord))
+				// the move is shown right away, but can still be undone
+				// until the remote end confirmed it. Only remote ends
+				// that understand the binary format send confirmations.
+				bool confirmed = !m_setup && CyvasseWSClient::instance().useBinary();
+
+				MatchState before;
+				if (confirmed)
+				{
+					before = saveState();
+					m_deferEndGame = true;
+				}
+
+				bool moved = tryMovePiece(m_selectedPiece, coord);
+				m_deferEndGame = false;
+
+				if (moved)
 				{
 					// move is valid and was done
 
 					if (!m_setup)
 					{
+						uint32_t seq;
+
 						if (piece)
-							CyvasseWSClient::instance().send(json::gameMsgMoveCapture(
+							seq = gamemsg::sendMoveCapture(
 								m_selectedPiece->getType(), oldCoord, coord, piece->getType(), coord
-							));
+							);
 						else
-							CyvasseWSClient::instance().send(json::gameMsgMove(
+							seq = gamemsg::sendMove(
 								m_selectedPiece->getType(), oldCoord, coord
-							));
+							);
+
+						if (confirmed)
+							m_pendingMoves.push_back({seq, move(before), m_deferredWinner});
 					}
 
+					m_deferredWinner = PlayersColor::UNDEFINED;
+
 					if (!m_setupAccepted)
 						m_self.checkSetupComplete();
 
@@ -291,9 +324,10 @@ namespace mikelepage
 			// send before modifying m_activePieces, so the map doesn't
 			// have to be filtered for only black / white pieces
 			assert(m_activePieces.size() == 26);
-			CyvasseWSClient::instance().send(json::gameMsgSetIsReady());
-			CyvasseWSClient::instance().send(json::gameMsgSetOpeningArray(m_activePieces));
+			gamemsg::sendSetIsReady();
+			gamemsg::sendSetOpeningArray(m_activePieces);
 
+			requestRedraw(); // hide the button
 			tryLeaveSetup();
 		}
 
@@ -305,8 +339,179 @@ namespace mikelepage
 		}
 	}
 
+	void RenderedMatch::onResized(const fea::Event::ResizeEvent&)
+	{
+		m_board.updateLayout(m_renderer.getViewport().getSize());
+
+		// reposition everything that is placed relative to the board,
+		// the textures and quads themselves stay the same
+
+		for (auto&& it : m_activePieces)
+			dynamic_cast<RenderedPiece&>(*it.second).updateLayout();
+
+		for (auto&& it : m_self.getInactivePieces())
+			dynamic_cast<RenderedPiece&>(*it.second).updateLayout();
+
+		for (auto&& it : m_op.getInactivePieces())
+			dynamic_cast<RenderedPiece&>(*it.second).updateLayout();
+
+		for (auto&& piece : dynamic_cast<RemotePlayer&>(m_op).getPieceCache())
+			piece->updateLayout();
+
+		for (auto&& it : m_terrain)
+			dynamic_cast<RenderedTerrain&>(*it.second).updateLayout();
+
+		dynamic_cast<RenderedFortress&>(m_self.getFortress()).updateLayout();
+		dynamic_cast<RenderedFortress&>(m_op.getFortress()).updateLayout();
+
+		positionSetupDoneButton();
+		positionPromotionPieces();
+
+		requestRedraw();
+	}
+
+	void RenderedMatch::onKeyPressed(const fea::Event::KeyEvent& event)
+	{
+		// escape has to be pressed twice to resign, any other key cancels
+		if (event.code == fea::Keyboard::ESCAPE)
+		{
+			if (m_resignRequested)
+			{
+				gamemsg::sendResign();
+				endGame(m_opColor);
+				return;
+			}
+
+			m_resignRequested = true;
+			setStatus("Press escape again to resign");
+		}
+		else if (m_resignRequested)
+		{
+			m_resignRequested = false;
+
+			if (m_setup)
+				setStatus("Setup");
+			else
+				updateTurnStatus();
+		}
+	}
+
+	void RenderedMatch::onMovesConfirmed(uint32_t seq)
+	{
+		while (!m_pendingMoves.empty() && m_pendingMoves.front().seq <= seq)
+		{
+			PlayersColor winner = m_pendingMoves.front().winner;
+			m_pendingMoves.pop_front();
+
+			if (winner != PlayersColor::UNDEFINED)
+			{
+				m_pendingMoves.clear();
+				endGame(winner);
+				return;
+			}
+		}
+	}
+
+	void RenderedMatch::onMoveRejected(uint32_t seq)
+	{
+		// everything before the rejected message was handled
+		onMovesConfirmed(seq - 1);
+
+		if (m_pendingMoves.empty() || m_gameEnded)
+			return;
+
+		// the rejected message and everything after it is undone,
+		// going back to the last state both sides agreed on
+		restoreState(m_pendingMoves.front().before);
+		m_pendingMoves.clear();
+
+		setStatus("Move rejected by the opponent, " + PlayersColorToPrettyStr(m_activePlayer) + "'s turn");
+	}
+
+	RenderedMatch::MatchState RenderedMatch::saveState()
+	{
+		MatchState state;
+
+		state.activePlayer = m_activePlayer;
+
+		state.activePieces.reserve(m_activePieces.size());
+		for (auto&& it : m_activePieces)
+			state.activePieces.push_back({it.second, *it.second->getCoord(), it.second->getType()});
+
+		state.self = {m_self.getInactivePieces(), m_self.m_kingTaken, m_self.getFortress().isRuined};
+
+		auto& op = dynamic_cast<RemotePlayer&>(m_op);
+		state.op = {op.getInactivePieces(), op.m_kingTaken, op.getFortress().isRuined};
+
+		state.lastMove = m_lastMove;
+
+		return state;
+	}
+
+	void RenderedMatch::restoreState(const MatchState& state)
+	{
+		// pieces that are on the board now, but weren't before
+		// would stay rendered, so collect the current ones first
+		set<shared_ptr<cyvmath::mikelepage::Piece>> onBoard;
+		for (auto&& it : m_activePieces)
+			onBoard.insert(it.second);
+
+		m_activePieces.clear();
+
+		for (auto&& it : state.activePieces)
+		{
+			auto piece = dynamic_pointer_cast<RenderedPiece>(it.piece);
+			assert(piece);
+
+			piece->resetCoord(it.coord);
+			piece->resetType(it.type);
+			m_activePieces.emplace(it.coord, piece);
+
+			// captured pieces are put back onto the board
+			if (!onBoard.erase(piece))
+				piece->setRenderHandle(getRenderLayer(RenderPriority::PIECE).add(piece->getQuad()));
+		}
+
+		for (auto&& piece : onBoard)
+		{
+			auto rPiece = dynamic_pointer_cast<RenderedPiece>(piece);
+
+			getRenderLayer(RenderPriority::PIECE).remove(rPiece->getRenderHandle());
+			rPiece->setRenderHandle(RenderList::invalidHandle);
+		}
+
+		auto restorePlayer = [](cyvmath::mikelepage::Player& player, bool& kingTaken, const MatchState::PlayerState& playerState) {
+			player.getInactivePieces() = playerState.inactivePieces;
+			kingTaken = playerState.kingTaken;
+
+			auto& fortress = dynamic_cast<RenderedFortress&>(player.getFortress());
+			if (fortress.isRuined && !playerState.fortressRuined)
+				fortress.repaired();
+		};
+
+		auto& op = dynamic_cast<RemotePlayer&>(m_op);
+		restorePlayer(m_self, m_self.m_kingTaken, state.self);
+		restorePlayer(op, op.m_kingTaken, state.op);
+
+		m_bearingTable.init();
+		m_activePlayer = state.activePlayer;
+
+		m_hoveredPiece.reset();
+		m_selectedPiece.reset();
+		m_board.clearHighlighting(HighlightingId::SEL);
+		m_board.clearHighlighting(HighlightingId::PTT);
+
+		m_lastMove = state.lastMove;
+		m_board.clearHighlighting(HighlightingId::LAST_MOVE);
+		m_board.highlightTiles(m_lastMove.begin(), m_lastMove.end(), HighlightingId::LAST_MOVE);
+
+		invalidateTargetTiles();
+		requestRedraw();
+	}
+
 	void RenderedMatch::onMouseMovedPromotionPieceSelect(const fea::Event::MouseMoveEvent& mouseMove)
 	{
+		auto oldHover = m_piecePromotionHover;
 		bool hoverOne = false;
 
 		for (int i = 0; i < m_renderPiecePromotionBgs; i++)
@@ -324,6 +529,9 @@ namespace mikelepage
 
 		if (!hoverOne)
 			m_piecePromotionHover = 0;
+
+		if (m_piecePromotionHover != oldHover)
+			requestRedraw();
 	}
 
 	void RenderedMatch::onMouseButtonPressedPromotionPieceSelect(const fea::Event::MouseButtonEvent& mouseButton)
@@ -345,14 +553,13 @@ namespace mikelepage
 			auto piece = getPieceAt(m_self.getFortress().getCoord());
 			assert(piece);
 
-			PieceType origType = piece->getType();
 			PieceType newType = m_piecePromotionTypes[m_piecePromotionMousePress-1];
 
-			piece->promoteTo(newType);
-			CyvasseWSClient::instance().send(json::gameMsgPromote(origType, newType));
+			promote(piece, newType);
 
 			m_renderPiecePromotionBgs = 0;
 			m_piecePromotionPieces.fill(nullptr);
+			requestRedraw();
 
 			m_ingameState.onMouseMoved          = bind(&Board::onMouseMoved, &m_board, _1);
 			m_ingameState.onMouseButtonPressed  = bind(&Board::onMouseButtonPressed, &m_board, _1);
@@ -370,6 +577,7 @@ namespace mikelepage
 		assert(coord);
 
 		m_activePieces.emplace(*coord, piece);
+		invalidateTargetTiles();
 
 		TerrainType tType = piece->getSetupTerrain();
 
@@ -378,10 +586,11 @@ namespace mikelepage
 			auto terrain = make_shared<RenderedTerrain>(tType, *coord, m_board, m_terrain);
 
 			m_terrain.emplace(*coord, terrain);
-			m_renderedEntities[RenderPriority::TERRAIN].push_back(terrain->getQuad());
+			getRenderLayer(RenderPriority::TERRAIN).add(terrain->getQuad());
 		}
 
-		m_renderedEntities[RenderPriority::PIECE].push_back(piece->getQuad());
+		piece->setRenderHandle(getRenderLayer(RenderPriority::PIECE).add(piece->getQuad()));
+		requestRedraw();
 	}
 
 	void RenderedMatch::placePiecesSetup()
@@ -421,7 +630,8 @@ namespace mikelepage
 		auto& op = dynamic_cast<RemotePlayer&>(m_op);
 
 		auto& opFortress = dynamic_cast<RenderedFortress&>(op.getFortress());
-		m_renderedEntities[RenderPriority::FORTRESS].push_back(opFortress.getQuad());
+		getRenderLayer(RenderPriority::FORTRESS).add(opFortress.getQuad());
+		requestRedraw();
 
 		for (auto&& piece : op.getPieceCache())
 			placePiece(piece);
@@ -443,6 +653,8 @@ namespace mikelepage
 
 		if (piece->moveTo(coord, m_setup))
 		{
+			invalidateTargetTiles();
+			requestRedraw();
 			m_board.clearHighlighting(HighlightingId::PTT);
 
 			if (!m_setup)
@@ -456,8 +668,8 @@ namespace mikelepage
 				if (m_activePlayer == m_ownColor)
 					m_self.onTurnBegin();
 
-				array<Coordinate, 2> coords = {{coord, *oldCoord}};
-				m_board.highlightTiles(coords.begin(), coords.end(), HighlightingId::LAST_MOVE);
+				m_lastMove = {coord, *oldCoord};
+				m_board.highlightTiles(m_lastMove.begin(), m_lastMove.end(), HighlightingId::LAST_MOVE);
 			}
 
 			return true;
@@ -466,21 +678,47 @@ namespace mikelepage
 		return false;
 	}
 
+	void RenderedMatch::promote(shared_ptr<cyvmath::mikelepage::Piece> piece, PieceType newType)
+	{
+		assert(piece && piece->getColor() == m_ownColor);
+
+		// promotions can be rejected like moves
+		bool confirmed = CyvasseWSClient::instance().useBinary();
+
+		MatchState before;
+		if (confirmed)
+			before = saveState();
+
+		PieceType origType = piece->getType();
+
+		piece->promoteTo(newType);
+		invalidateTargetTiles();
+		requestRedraw();
+
+		uint32_t seq = gamemsg::sendPromote(origType, newType);
+
+		if (confirmed)
+			m_pendingMoves.push_back({seq, move(before), PlayersColor::UNDEFINED});
+	}
+
 	void RenderedMatch::addToBoard(PieceType type, PlayersColor color, const HexCoordinate& coord)
 	{
 		Match::addToBoard(type, color, coord);
+		invalidateTargetTiles();
 
 		auto rPiece = dynamic_pointer_cast<RenderedPiece>(getPieceAt(coord));
 		assert(rPiece);
 
-		rPiece->setPosition(m_board.getTileAt(coord)->getPosition());
+		rPiece->setPosition(m_board.getTilePosition(coord));
 
-		m_renderedEntities[RenderPriority::PIECE].push_back(rPiece->getQuad());
+		rPiece->setRenderHandle(getRenderLayer(RenderPriority::PIECE).add(rPiece->getQuad()));
+		requestRedraw();
 	}
 
 	void RenderedMatch::removeFromBoard(shared_ptr<cyvmath::mikelepage::Piece> piece)
 	{
 		Match::removeFromBoard(piece);
+		invalidateTargetTiles();
 
 		// TODO: place the piece somewhere outside
 		// the board instead of not rendering it
@@ -488,11 +726,9 @@ namespace mikelepage
 		auto rPiece = dynamic_pointer_cast<RenderedPiece>(piece);
 		assert(rPiece);
 
-		auto& piecesToRender = m_renderedEntities[RenderPriority::PIECE];
-
-		auto it = find(piecesToRender.begin(), piecesToRender.end(), rPiece->getQuad());
-		assert(it != piecesToRender.end());
-		piecesToRender.erase(it);
+		getRenderLayer(RenderPriority::PIECE).remove(rPiece->getRenderHandle());
+		rPiece->setRenderHandle(RenderList::invalidHandle);
+		requestRedraw();
 	}
 
 	void RenderedMatch::updateTurnStatus()
@@ -513,28 +749,31 @@ namespace mikelepage
 			return;
 
 		// the tile clicked on holds a piece of the player
-		auto pTT = m_hoveredPiece->getPossibleTargetTiles();
+		const auto& pTT = getPossibleTargetTiles(*m_hoveredPiece);
 		m_board.highlightTiles(pTT.begin(), pTT.end(), HighlightingId::PTT);
 	}
 
+	const cyvmath::mikelepage::CoordinateSet& RenderedMatch::getPossibleTargetTiles(const cyvmath::mikelepage::Piece& piece)
+	{
+		assert(piece.getCoord());
+		size_t index = Board::Index::index(*piece.getCoord());
+
+		// moving the mouse over the pieces only looks the tiles up,
+		// they are calculated once per piece and board state
+		if (!m_targetTileCacheValid.test(index))
+		{
+			m_targetTileCache[index] = piece.getPossibleTargetTiles();
+			m_targetTileCacheValid.set(index);
+		}
+
+		return m_targetTileCache[index];
+	}
+
 	void RenderedMatch::showPromotionPieces(set<PieceType> pieceTypes)
 	{
 		assert(pieceTypes.size() > 1 && pieceTypes.size() <= 3);
 
 		m_renderPiecePromotionBgs = pieceTypes.size();
-		glm::uvec2 scrMid = m_renderer.getViewport().getSize() / glm::uvec2{2, 2};
-
-		if (pieceTypes.size() == 2)
-		{
-			m_piecePromotionBackground[0].setPosition(glm::ivec2(scrMid) + glm::ivec2{-100, -50});
-			m_piecePromotionBackground[1].setPosition(glm::ivec2(scrMid) + glm::ivec2{0, -50});
-		}
-		else
-		{
-			m_piecePromotionBackground[0].setPosition(glm::ivec2(scrMid) + glm::ivec2{-150, -50});
-			m_piecePromotionBackground[1].setPosition(glm::ivec2(scrMid) + glm::ivec2{-50, -50});
-			m_piecePromotionBackground[2].setPosition(glm::ivec2(scrMid) + glm::ivec2{50, -50});
-		}
 
 		auto& inactivePieces = m_self.getInactivePieces();
 
@@ -549,18 +788,58 @@ namespace mikelepage
 			auto rPiece = dynamic_pointer_cast<RenderedPiece>(it->second);
 			assert(rPiece);
 
-			rPiece->setPosition(m_piecePromotionBackground[i].getPosition() + glm::vec2{17, 25}); // TODO
 			m_piecePromotionPieces[i] = rPiece->getQuad();
 			i++;
 		}
 
+		positionPromotionPieces();
+		requestRedraw();
+
 		m_ingameState.onMouseMoved          = bind(&RenderedMatch::onMouseMovedPromotionPieceSelect, this, _1);
 		m_ingameState.onMouseButtonPressed  = bind(&RenderedMatch::onMouseButtonPressedPromotionPieceSelect, this, _1);
 		m_ingameState.onMouseButtonReleased = bind(&RenderedMatch::onMouseButtonReleasedPromotionPieceSelect, this, _1);
 	}
 
+	void RenderedMatch::positionPromotionPieces()
+	{
+		if (m_renderPiecePromotionBgs == 0)
+			return;
+
+		glm::uvec2 scrMid = m_renderer.getViewport().getSize() / glm::uvec2{2, 2};
+
+		if (m_renderPiecePromotionBgs == 2)
+		{
+			m_piecePromotionBackground[0].setPosition(glm::ivec2(scrMid) + glm::ivec2{-100, -50});
+			m_piecePromotionBackground[1].setPosition(glm::ivec2(scrMid) + glm::ivec2{0, -50});
+		}
+		else
+		{
+			m_piecePromotionBackground[0].setPosition(glm::ivec2(scrMid) + glm::ivec2{-150, -50});
+			m_piecePromotionBackground[1].setPosition(glm::ivec2(scrMid) + glm::ivec2{-50, -50});
+			m_piecePromotionBackground[2].setPosition(glm::ivec2(scrMid) + glm::ivec2{50, -50});
+		}
+
+		for (int i = 0; i < m_renderPiecePromotionBgs; i++)
+			m_piecePromotionPieces[i]->setPosition(m_piecePromotionBackground[i].getPosition() + glm::vec2{17, 25}); // TODO
+	}
+
+	void RenderedMatch::positionSetupDoneButton()
+	{
+		glm::uvec2 boardSize = m_board.getSize();
+		glm::uvec2 boardPos = m_board.getPosition();
+
+		m_buttonSetupDone.setPosition(boardPos + boardSize - glm::uvec2(m_buttonSetupDone.getSize()));
+	}
+
 	void RenderedMatch::endGame(PlayersColor winner)
 	{
+		// the move that ended the game may still be rejected
+		if (m_deferEndGame)
+		{
+			m_deferredWinner = winner;
+			return;
+		}
+
 		setStatus(PlayersColorToPrettyStr(winner) + " won!");
 
 		m_board.clearHighlighting(HighlightingId::PTT);
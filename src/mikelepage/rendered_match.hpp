@@ -20,12 +20,19 @@
 #include <cyvmath/mikelepage/match.hpp>
 
 #include <array>
+#include <cstdint>
+#include <deque>
 #include <set>
+#include <vector>
+#include <fea/rendering/animatedquad.hpp>
 #include <fea/rendering/quad.hpp>
 #include <fea/rendering/renderer2d.hpp>
 #include <fea/ui/event.hpp>
 
+#include "bitboard.hpp"
 #include "hexagon_board.hpp"
+#include "promotion.hpp"
+#include "render_list.hpp"
 
 // higher priority (bigger enum value) means rendered later -> on top
 enum class RenderPriority
@@ -35,6 +42,8 @@ enum class RenderPriority
 	FORTRESS
 };
 
+const std::size_t renderPriorityCount = static_cast<std::size_t>(RenderPriority::FORTRESS) + 1;
+
 class IngameState;
 
 namespace mikelepage
@@ -61,12 +70,12 @@ namespace mikelepage
 			LocalPlayer& m_self;
 			cyvmath::mikelepage::Player& m_op;
 
-			std::map<RenderPriority, std::vector<fea::Drawable2D*>> m_renderedEntities;
+			std::array<RenderList, renderPriorityCount> m_renderLayers;
 
 			bool m_setupAccepted;
+			bool m_resignRequested;
 
-			fea::Texture m_buttonSetupDoneTexture;
-			fea::Quad m_buttonSetupDone;
+			fea::AnimatedQuad m_buttonSetupDone;
 
 			std::array<fea::Quad, 3> m_piecePromotionBackground;
 			std::array<fea::Quad*, 3> m_piecePromotionPieces;
@@ -76,6 +85,64 @@ namespace mikelepage
 
 			std::shared_ptr<cyvmath::mikelepage::Piece> m_hoveredPiece, m_selectedPiece;
 
+			// everything a move or promotion can change, to go back to the
+			// last state both sides agreed on when the remote end rejects it
+			struct MatchState
+			{
+				struct PieceState
+				{
+					std::shared_ptr<cyvmath::mikelepage::Piece> piece;
+					HexCoordinate coord;
+					cyvmath::PieceType type;
+				};
+
+				struct PlayerState
+				{
+					InactivePieceMap inactivePieces;
+					bool kingTaken;
+					bool fortressRuined;
+				};
+
+				cyvmath::PlayersColor activePlayer;
+				std::vector<PieceState> activePieces;
+				PlayerState self, op;
+				std::vector<cyvmath::Coordinate> lastMove;
+			};
+
+			// a move or promotion that was done locally and
+			// sent, but not confirmed by the remote end yet
+			struct PendingMove
+			{
+				uint32_t seq;
+				MatchState before;
+				// set if the move ended the game, which
+				// only happens once it is confirmed
+				cyvmath::PlayersColor winner;
+			};
+
+			std::deque<PendingMove> m_pendingMoves;
+
+			// tiles of the LAST_MOVE highlighting
+			std::vector<cyvmath::Coordinate> m_lastMove;
+
+			// while a local move is done that can still be rejected,
+			// endGame() only records the winner in m_deferredWinner
+			bool m_deferEndGame;
+			cyvmath::PlayersColor m_deferredWinner;
+
+			// possible target tiles of the pieces on the board by tile index,
+			// calculated when first needed and kept until the board changes
+			std::array<cyvmath::mikelepage::CoordinateSet, Board::Index::tileCount> m_targetTileCache;
+			Bitboard m_targetTileCacheValid;
+
+			const cyvmath::mikelepage::CoordinateSet& getPossibleTargetTiles(const cyvmath::mikelepage::Piece&);
+
+			MatchState saveState();
+			void restoreState(const MatchState&);
+
+			RenderList& getRenderLayer(RenderPriority priority)
+			{ return m_renderLayers[static_cast<std::size_t>(priority)]; }
+
 		public:
 			RenderedMatch(IngameState&, fea::Renderer2D&, cyvmath::PlayersColor);
 
@@ -91,12 +158,23 @@ namespace mikelepage
 
 			void setStatus(const std::string&);
 
+			// has to be called when anything visible changed,
+			// so the next frame is rendered
+			void requestRedraw();
+
 			void tick();
 
 			void onTileMouseOver(cyvmath::Coordinate);
 			void onTileClicked(cyvmath::Coordinate);
 			void onMouseMoveOutside(const fea::Event::MouseMoveEvent&);
 			void onClickedOutsideBoard(const fea::Event::MouseButtonEvent&);
+			void onResized(const fea::Event::ResizeEvent&);
+			void onKeyPressed(const fea::Event::KeyEvent&);
+
+			// called when the remote end confirmed all game messages up
+			// to seq, or rejected the game message seq
+			void onMovesConfirmed(uint32_t seq);
+			void onMoveRejected(uint32_t seq);
 
 			void tickPromotionPieceSelect();
 
@@ -109,13 +187,22 @@ namespace mikelepage
 
 			void tryLeaveSetup();
 			bool tryMovePiece(std::shared_ptr<cyvmath::mikelepage::Piece>, cyvmath::Coordinate);
+			// promotes a piece of the local player and sends the promotion
+			void promote(std::shared_ptr<cyvmath::mikelepage::Piece>, cyvmath::PieceType);
 			void addToBoard(cyvmath::PieceType, cyvmath::PlayersColor, const HexCoordinate&) final override;
 			void removeFromBoard(std::shared_ptr<cyvmath::mikelepage::Piece>) final override;
 
+			// has to be called when anything on the board changed that
+			// can affect where the pieces can move, like a promotion
+			void invalidateTargetTiles()
+			{ m_targetTileCacheValid = Bitboard(); }
+
 			void updateTurnStatus();
 			void showPossibleTargetTiles();
 
 			void showPromotionPieces(std::set<cyvmath::PieceType>);
+			void positionPromotionPieces();
+			void positionSetupDoneButton();
 			void endGame(cyvmath::PlayersColor winner) final override;
 	};
 }
@@ -18,7 +18,7 @@
 
 #include <cyvmath/mikelepage/match.hpp>
 #include "hexagon_board.hpp"
-#include "texturemaker.hpp" // lodepng helper function
+#include "texture_atlas.hpp"
 #include "rendered_match.hpp"
 
 using namespace std;
@@ -30,6 +30,7 @@ namespace mikelepage
 		: Piece(color, type, coord, match)
 		, m_board(match.getBoard())
 		, m_quad(m_board.getTileSize())
+		, m_renderHandle(RenderList::invalidHandle)
 	{
 		static const map<PieceType, string> fileNames {
 				{PieceType::MOUNTAINS,   "mountains.png"},
@@ -45,9 +46,7 @@ namespace mikelepage
 			};
 
 		string texturePath = "res/icons/" + string(PlayersColorToStr(color)) + "/" + fileNames.at(type);
-		m_texture = makeTexture(texturePath).first;
-
-		m_quad.setTexture(m_texture);
+		TextureAtlas::instance().apply(m_quad, texturePath);
 		m_quad.setPosition(m_board.getTilePosition(*m_coord));
 	}
 
@@ -60,4 +59,19 @@ namespace mikelepage
 
 		return true;
 	}
+
+	void RenderedPiece::resetCoord(const HexCoordinate& coord)
+	{
+		m_coord = coord;
+		m_quad.setPosition(m_board.getTilePosition(coord));
+	}
+
+	void RenderedPiece::updateLayout()
+	{
+		m_quad.setSize(m_board.getTileSize());
+
+		// pieces that aren't on the board are positioned by their user
+		if(m_coord)
+			m_quad.setPosition(m_board.getTilePosition(*m_coord));
+	}
 }
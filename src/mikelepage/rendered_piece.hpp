@@ -18,7 +18,8 @@
 #define _MIKELEPAGE_RENDERED_PIECE_HPP_
 
 #include <cyvmath/mikelepage/piece.hpp>
-#include <fea/rendering/quad.hpp>
+#include <fea/rendering/animatedquad.hpp>
+#include "render_list.hpp"
 
 template<int> class HexagonBoard;
 
@@ -31,8 +32,11 @@ namespace mikelepage
 		private:
 			HexagonBoard<6>& m_board;
 
-			fea::Quad m_quad;
-			fea::Texture m_texture;
+			fea::AnimatedQuad m_quad;
+
+			// handle in the render list of the match,
+			// only valid while the piece is on the board
+			RenderList::Handle m_renderHandle;
 
 		public:
 			RenderedPiece(cyvmath::PieceType, const HexCoordinate&, cyvmath::PlayersColor, RenderedMatch&);
@@ -40,6 +44,10 @@ namespace mikelepage
 			fea::Quad* getQuad()
 			{ return &m_quad; }
 
+			// updates size and position of the quad
+			// after the layout of the board changed
+			void updateLayout();
+
 			const glm::vec2& getPosition() const
 			{ return m_quad.getPosition(); }
 
@@ -47,6 +55,21 @@ namespace mikelepage
 
 			void setPosition(const glm::vec2& pos)
 			{ m_quad.setPosition(pos); }
+
+			// puts the piece onto coord without checking any rules,
+			// only for undoing moves
+			void resetCoord(const HexCoordinate& coord);
+
+			// changes the type without checking any rules,
+			// only for undoing promotions
+			void resetType(cyvmath::PieceType type)
+			{ m_type = type; }
+
+			RenderList::Handle getRenderHandle() const
+			{ return m_renderHandle; }
+
+			void setRenderHandle(RenderList::Handle handle)
+			{ m_renderHandle = handle; }
 	};
 
 	typedef std::vector<std::shared_ptr<RenderedPiece>> RenderedPieceVec;
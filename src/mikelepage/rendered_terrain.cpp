@@ -18,7 +18,7 @@
 
 #include <map>
 #include "hexagon_board.hpp"
-#include "texturemaker.hpp" // lodepng helper function
+#include "texture_atlas.hpp"
 
 using namespace std;
 using namespace cyvmath;
@@ -36,9 +36,7 @@ namespace mikelepage
 		assert(type != TerrainType::UNDEFINED);
 
 		string texturePath = "res/icons/" + TerrainTypeToStr(type) + ".png";
-		m_texture = makeTexture(texturePath).first;
-
-		m_quad.setTexture(m_texture);
+		TextureAtlas::instance().apply(m_quad, texturePath);
 		m_quad.setPosition(board.getTilePosition(coord));
 	}
 
@@ -55,4 +53,10 @@ namespace mikelepage
 		m_terrainMap.erase(it);
 		m_terrainMap.emplace(coord, selfSharedPtr);
 	}
+
+	void RenderedTerrain::updateLayout()
+	{
+		m_quad.setSize(m_board.getTileSize());
+		m_quad.setPosition(m_board.getTilePosition(m_coord));
+	}
 }
@@ -18,7 +18,7 @@
 #define _MIKELEPAGE_RENDERED_TERRAIN_HPP_
 
 #include <cyvmath/mikelepage/terrain.hpp>
-#include <fea/rendering/quad.hpp>
+#include <fea/rendering/animatedquad.hpp>
 
 template<int> class HexagonBoard;
 
@@ -32,8 +32,7 @@ namespace mikelepage
 			HexagonBoard<6>& m_board;
 			TerrainMap& m_terrainMap;
 
-			fea::Quad m_quad;
-			fea::Texture m_texture;
+			fea::AnimatedQuad m_quad;
 
 		public:
 			RenderedTerrain(cyvmath::mikelepage::TerrainType, cyvmath::Coordinate, HexagonBoard<6>&, TerrainMap&);
@@ -41,6 +40,10 @@ namespace mikelepage
 			fea::Quad* getQuad()
 			{ return &m_quad; }
 
+			// updates size and position of the quad
+			// after the layout of the board changed
+			void updateLayout();
+
 			void setCoord(cyvmath::Coordinate) final override;
 	};
 }
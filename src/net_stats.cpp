@@ -0,0 +1,73 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "net_stats.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+
+void RollingSamples::add(int32_t sample)
+{
+	m_samples[m_next] = sample;
+	m_next = (m_next + 1) % sampleCount;
+
+	if(m_size < sampleCount)
+		m_size++;
+}
+
+int32_t RollingSamples::percentile(float p) const
+{
+	assert(p >= 0 && p <= 1);
+
+	if(m_size == 0)
+		return 0;
+
+	auto sorted = m_samples;
+	auto nth = sorted.begin() + static_cast<std::size_t>(std::lround(p * (m_size - 1)));
+
+	std::nth_element(sorted.begin(), nth, sorted.begin() + m_size);
+	return *nth;
+}
+
+void NetStats::addPing(uint64_t t0, uint64_t t1, uint64_t t2, uint64_t t3)
+{
+	int64_t rtt = static_cast<int64_t>(t3 - t0) - static_cast<int64_t>(t2 - t1);
+	if(rtt < 0)
+		rtt = 0;
+
+	if(m_lastRtt >= 0)
+		m_jitter += (std::abs(static_cast<float>(rtt - m_lastRtt)) - m_jitter) / 16;
+
+	m_lastRtt = static_cast<int32_t>(rtt);
+	m_rtt.add(m_lastRtt);
+
+	m_clockOffset = (static_cast<int64_t>(t1 - t0) + static_cast<int64_t>(t2 - t3)) / 2;
+}
+
+int32_t NetStats::addMessage(uint64_t remoteTime, uint64_t renderTime)
+{
+	// without a clock offset the latency can't be calculated
+	if(!hasClockOffset())
+		return -1;
+
+	int64_t inputTime = static_cast<int64_t>(remoteTime) - m_clockOffset;
+	int32_t latency = static_cast<int32_t>(static_cast<int64_t>(renderTime) - inputTime);
+
+	m_messageLatency.add(latency);
+	return latency;
+}
@@ -0,0 +1,112 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _NET_STATS_HPP_
+#define _NET_STATS_HPP_
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// milliseconds since the epoch, used for all timestamps sent over the network
+inline uint64_t netTime()
+{
+	using namespace std::chrono;
+	return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+/* Keeps the last sampleCount values added to it,
+ * older ones are overwritten.
+ */
+class RollingSamples
+{
+	public:
+		static const std::size_t sampleCount = 64;
+
+	private:
+		std::array<int32_t, sampleCount> m_samples;
+		std::size_t m_next;
+		std::size_t m_size;
+
+	public:
+		RollingSamples()
+			: m_next(0)
+			, m_size(0)
+		{ }
+
+		void add(int32_t sample);
+
+		std::size_t size() const
+		{ return m_size; }
+
+		// p in [0, 1], e.g. 0.5 for the median. Returns 0 if there are no samples.
+		int32_t percentile(float p) const;
+};
+
+/* Network latency measurements of a CyvasseWSClient. All values are in
+ * milliseconds. The remote end of the measurements is the other player,
+ * as the server only relays the messages.
+ */
+class NetStats
+{
+	private:
+		RollingSamples m_rtt;
+		RollingSamples m_messageLatency;
+
+		float m_jitter;
+		int32_t m_lastRtt;
+		int64_t m_clockOffset;
+
+	public:
+		NetStats()
+			: m_jitter(0)
+			, m_lastRtt(-1)
+			, m_clockOffset(0)
+		{ }
+
+		// adds the result of one ping, with the timestamps of sending the
+		// ping (t0), the remote end receiving it (t1) and sending the
+		// pong (t2) and receiving the pong (t3)
+		void addPing(uint64_t t0, uint64_t t1, uint64_t t2, uint64_t t3);
+
+		// adds the latency of a game message caused by input on the remote
+		// end at remoteTime (in the remote end's clock), whose result was
+		// rendered here at renderTime. Returns the latency, or -1 if it
+		// can't be calculated yet.
+		int32_t addMessage(uint64_t remoteTime, uint64_t renderTime);
+
+		bool hasClockOffset() const
+		{ return m_rtt.size() > 0; }
+
+		// round trip time
+		const RollingSamples& getRtt() const
+		{ return m_rtt; }
+
+		// time from the remote click until its result was rendered here
+		const RollingSamples& getMessageLatency() const
+		{ return m_messageLatency; }
+
+		// smoothed variation of the round trip time, as in RFC 3550
+		float getJitter() const
+		{ return m_jitter; }
+
+		// remote clock minus local clock, from the last ping
+		int64_t getClockOffset() const
+		{ return m_clockOffset; }
+};
+
+#endif // _NET_STATS_HPP_
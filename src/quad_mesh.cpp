@@ -0,0 +1,68 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quad_mesh.hpp"
+
+#include <fea/rendering/opengl.hpp>
+
+// two triangles per quad
+static const std::size_t verticesPerQuad = 6;
+
+QuadMesh::QuadMesh()
+{
+	mDrawMode = GL_TRIANGLES;
+}
+
+void QuadMesh::clear()
+{
+	mVertices.clear();
+	mTexCoords.clear();
+	mVertexColors.clear();
+}
+
+void QuadMesh::reserve(std::size_t quadCount)
+{
+	mVertices.reserve(quadCount * verticesPerQuad * 2);
+	mTexCoords.reserve(quadCount * verticesPerQuad * 2);
+	mVertexColors.reserve(quadCount * verticesPerQuad * 4);
+}
+
+void QuadMesh::addQuad(const glm::vec2& pos, const glm::vec2& size, const fea::Color& color)
+{
+	const float left = pos.x, top = pos.y;
+	const float right = pos.x + size.x, bottom = pos.y + size.y;
+
+	mVertices.insert(mVertices.end(), {
+		left,  top,
+		left,  bottom,
+		right, top,
+
+		right, top,
+		left,  bottom,
+		right, bottom
+	});
+
+	// no texture is used, but the renderer expects
+	// texture coordinates for every vertex
+	mTexCoords.insert(mTexCoords.end(), verticesPerQuad * 2, 0.0f);
+
+	for(std::size_t i = 0; i < verticesPerQuad; i++)
+	{
+		mVertexColors.insert(mVertexColors.end(), {
+			color.rAsFloat(), color.gAsFloat(), color.bAsFloat(), color.aAsFloat()
+		});
+	}
+}
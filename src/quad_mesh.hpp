@@ -0,0 +1,39 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _QUAD_MESH_HPP_
+#define _QUAD_MESH_HPP_
+
+#include <cstddef>
+#include <fea/rendering/color.hpp>
+#include <fea/rendering/drawable2d.hpp>
+
+/* A set of untextured, single-colored rectangles that is
+ * drawn with one draw call. Meant for things that don't
+ * change every frame, like the tiles of the game board.
+ */
+class QuadMesh : public fea::Drawable2D
+{
+	public:
+		QuadMesh();
+
+		void clear();
+		void reserve(std::size_t quadCount);
+
+		void addQuad(const glm::vec2& pos, const glm::vec2& size, const fea::Color&);
+};
+
+#endif // _QUAD_MESH_HPP_
@@ -0,0 +1,64 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "render_list.hpp"
+
+#include <cassert>
+
+RenderList::Handle RenderList::add(fea::Drawable2D* drawable)
+{
+	assert(drawable);
+
+	Handle handle;
+
+	if(m_freeHandles.empty())
+	{
+		handle = m_indices.size();
+		m_indices.push_back(m_drawables.size());
+	}
+	else
+	{
+		handle = m_freeHandles.back();
+		m_freeHandles.pop_back();
+
+		m_indices[handle] = m_drawables.size();
+	}
+
+	m_drawables.push_back(drawable);
+	m_handles.push_back(handle);
+
+	return handle;
+}
+
+void RenderList::remove(Handle handle)
+{
+	assert(handle != invalidHandle && handle < m_indices.size());
+
+	std::size_t index = m_indices[handle];
+	assert(index < m_drawables.size() && m_handles[index] == handle);
+
+	// move the last element into the place of the removed one
+	m_drawables[index] = m_drawables.back();
+	m_handles[index] = m_handles.back();
+	m_indices[m_handles[index]] = index;
+
+	m_drawables.pop_back();
+	m_handles.pop_back();
+
+	// makes removing the same handle twice fail the assertion above
+	m_indices[handle] = SIZE_MAX;
+	m_freeHandles.push_back(handle);
+}
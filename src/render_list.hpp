@@ -0,0 +1,67 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _RENDER_LIST_HPP_
+#define _RENDER_LIST_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <fea/rendering/drawable2d.hpp>
+
+/* A list of drawables that are queued for rendering in one go.
+ *
+ * The drawables are stored contiguously. Adding one returns a
+ * handle that stays valid until it is removed again, no matter
+ * how many other drawables are added or removed in between.
+ * Removing swaps the last drawable into the free place, so the
+ * order of the drawables in the list isn't preserved.
+ *
+ * invalidHandle is never returned by add(), so it can be used
+ * for drawables that are currently not in the list.
+ */
+class RenderList
+{
+	public:
+		typedef std::size_t Handle;
+		typedef std::vector<fea::Drawable2D*>::const_iterator const_iterator;
+
+		static constexpr Handle invalidHandle = SIZE_MAX;
+
+	private:
+		std::vector<fea::Drawable2D*> m_drawables;
+		// the handle of every element of m_drawables
+		std::vector<Handle> m_handles;
+		// the index in m_drawables of every handle in use
+		std::vector<std::size_t> m_indices;
+		// handles that were used before and can be reused
+		std::vector<Handle> m_freeHandles;
+
+	public:
+		Handle add(fea::Drawable2D*);
+		void remove(Handle);
+
+		std::size_t size() const
+		{ return m_drawables.size(); }
+
+		const_iterator begin() const
+		{ return m_drawables.begin(); }
+
+		const_iterator end() const
+		{ return m_drawables.end(); }
+};
+
+#endif // _RENDER_LIST_HPP_
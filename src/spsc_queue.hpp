@@ -0,0 +1,119 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SPSC_QUEUE_HPP_
+#define _SPSC_QUEUE_HPP_
+
+#include <atomic>
+#include <utility>
+
+/* Unbounded lock-free queue for exactly one producer thread and
+ * exactly one consumer thread, implemented as a singly linked list.
+ * The consumer always owns a dummy node at the head, so push() and
+ * pop() never touch the same node pointer and no locking is needed.
+ *
+ * Nodes the consumer is done with stay in the list before the head,
+ * where the producer takes them from for new elements. New nodes are
+ * only allocated when more elements than ever before are queued, so
+ * in the steady state push() doesn't allocate.
+ */
+template <class T>
+class SPSCQueue
+{
+	private:
+		struct Node
+		{
+			T value;
+			std::atomic<Node*> next;
+
+			Node()
+				: next(nullptr)
+			{ }
+		};
+
+		// written by the consumer, read by the producer
+		std::atomic<Node*> m_head;
+
+		// only accessed by the producer
+		Node* m_tail;
+		Node* m_first;    // oldest node, all nodes up to m_headCopy can be reused
+		Node* m_headCopy; // last known value of m_head
+
+		Node* allocNode()
+		{
+			if(m_first == m_headCopy)
+			{
+				// see whether the consumer has moved on
+				m_headCopy = m_head.load(std::memory_order_acquire);
+
+				if(m_first == m_headCopy)
+					return new Node;
+			}
+
+			Node* node = m_first;
+			m_first = m_first->next.load(std::memory_order_relaxed);
+			return node;
+		}
+
+	public:
+		SPSCQueue()
+			: m_head(new Node)
+			, m_tail(m_head.load(std::memory_order_relaxed))
+			, m_first(m_tail)
+			, m_headCopy(m_tail)
+		{ }
+
+		~SPSCQueue()
+		{
+			while(m_first)
+			{
+				Node* next = m_first->next.load(std::memory_order_relaxed);
+				delete m_first;
+				m_first = next;
+			}
+		}
+
+		SPSCQueue(const SPSCQueue&) = delete;
+		SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+		// producer side
+		void push(T value)
+		{
+			Node* node = allocNode();
+			node->next.store(nullptr, std::memory_order_relaxed);
+			node->value = std::move(value);
+
+			m_tail->next.store(node, std::memory_order_release);
+			m_tail = node;
+		}
+
+		// consumer side, returns false if the queue is empty
+		bool pop(T& value)
+		{
+			Node* head = m_head.load(std::memory_order_relaxed);
+			Node* next = head->next.load(std::memory_order_acquire);
+			if(!next)
+				return false;
+
+			value = std::move(next->value);
+
+			// hands the old head over to the producer for reuse
+			m_head.store(next, std::memory_order_release);
+			return true;
+		}
+};
+
+#endif // _SPSC_QUEUE_HPP_
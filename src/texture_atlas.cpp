@@ -0,0 +1,159 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "texture_atlas.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+#include <lodepng.h>
+
+using namespace std;
+
+// WebGL 1 only fully supports textures with power-of-two sizes
+static const unsigned atlasWidth = 1024;
+
+// space between two images, so linear filtering
+// doesn't bleed one image into its neighbours
+static const unsigned imagePadding = 1;
+
+static unsigned nextPowerOfTwo(unsigned n)
+{
+	unsigned ret = 1;
+	while(ret < n)
+		ret *= 2;
+
+	return ret;
+}
+
+TextureAtlas& TextureAtlas::instance()
+{
+	static TextureAtlas atlas;
+	return atlas;
+}
+
+void TextureAtlas::build(const vector<string>& paths)
+{
+	assert(m_regions.empty());
+
+	struct Image
+	{
+		const string* path;
+		vector<unsigned char> pixels;
+		glm::uvec2 size;
+		glm::uvec2 pos;
+	};
+
+	vector<Image> images(paths.size());
+
+	for(size_t i = 0; i < paths.size(); i++)
+	{
+		auto& image = images[i];
+		image.path = &paths[i];
+
+		unsigned error = lodepng::decode(image.pixels, image.size.x, image.size.y, paths[i]);
+		if(error)
+			throw runtime_error("(lodepng) error loading " + paths[i] + ": " + lodepng_error_text(error));
+
+		if(image.size.x + imagePadding > atlasWidth)
+			throw runtime_error(paths[i] + " is too wide to be added to the texture atlas");
+	}
+
+	// simple shelf packing: highest images first,
+	// each row is as high as its first image
+	vector<Image*> sorted;
+	for(auto& image : images)
+		sorted.push_back(&image);
+
+	stable_sort(sorted.begin(), sorted.end(), [](const Image* a, const Image* b) {
+		return a->size.y > b->size.y;
+	});
+
+	glm::uvec2 cursor(0, 0);
+	unsigned rowHeight = 0;
+
+	for(auto image : sorted)
+	{
+		if(cursor.x + image->size.x + imagePadding > atlasWidth)
+		{
+			cursor.x = 0;
+			cursor.y += rowHeight;
+			rowHeight = 0;
+		}
+
+		image->pos = cursor;
+
+		cursor.x += image->size.x + imagePadding;
+		rowHeight = max(rowHeight, image->size.y + imagePadding);
+	}
+
+	const glm::uvec2 atlasSize(atlasWidth, nextPowerOfTwo(cursor.y + rowHeight));
+
+	// copy all images into one RGBA buffer
+	vector<unsigned char> atlasPixels(atlasSize.x * atlasSize.y * 4, 0);
+
+	for(const auto& image : images)
+	{
+		for(unsigned row = 0; row < image.size.y; row++)
+		{
+			memcpy(
+				&atlasPixels[((image.pos.y + row) * atlasSize.x + image.pos.x) * 4],
+				&image.pixels[row * image.size.x * 4],
+				image.size.x * 4
+			);
+		}
+	}
+
+	m_texture = make_unique<fea::Texture>();
+	m_texture->create(atlasSize.x, atlasSize.y, &atlasPixels[0]);
+
+	for(const auto& image : images)
+	{
+		glm::vec2 start(
+			image.pos.x / static_cast<float>(atlasSize.x),
+			image.pos.y / static_cast<float>(atlasSize.y)
+		);
+
+		glm::vec2 size(
+			image.size.x / static_cast<float>(atlasSize.x),
+			image.size.y / static_cast<float>(atlasSize.y)
+		);
+
+		m_regions.emplace(*image.path, Region{fea::Animation(start, size), image.size});
+	}
+}
+
+const glm::uvec2& TextureAtlas::getImageSize(const string& path) const
+{
+	return m_regions.at(path).size;
+}
+
+void TextureAtlas::apply(fea::AnimatedQuad& quad, const string& path) const
+{
+	// the quad keeps a pointer to the animation, which is
+	// fine because m_regions isn't modified after build()
+	assert(m_texture);
+
+	quad.setTexture(*m_texture);
+	quad.setAnimation(m_regions.at(path).subrect);
+}
+
+void TextureAtlas::release()
+{
+	m_regions.clear();
+	m_texture.reset();
+}
@@ -0,0 +1,77 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TEXTURE_ATLAS_HPP_
+#define _TEXTURE_ATLAS_HPP_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <fea/rendering/animatedquad.hpp>
+#include <fea/rendering/animation.hpp>
+#include <fea/rendering/texture.hpp>
+
+/* Packs all images the game uses into one texture, so every
+ * textured quad on the board uses the same texture object.
+ *
+ * Quads select their part of the atlas through a single-frame
+ * fea::Animation, which is the sub-rectangle (in texture
+ * coordinates) of the image they were requested for.
+ */
+class TextureAtlas
+{
+	private:
+		struct Region
+		{
+			fea::Animation subrect;
+			glm::uvec2 size; // in pixels
+		};
+
+		std::unique_ptr<fea::Texture> m_texture;
+		std::map<std::string, Region> m_regions;
+
+		TextureAtlas() = default;
+
+	public:
+		// non-copyable
+		TextureAtlas(const TextureAtlas&) = delete;
+		TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+		// there is only one OpenGL context, so there
+		// is no point in having more than one atlas
+		static TextureAtlas& instance();
+
+		// decodes all png files in paths and uploads them as one texture,
+		// has to be called after the renderer was set up
+		void build(const std::vector<std::string>& paths);
+
+		const fea::Texture& getTexture() const
+		{ return *m_texture; }
+
+		// size of the original image, in pixels
+		const glm::uvec2& getImageSize(const std::string& path) const;
+
+		// makes quad display the image loaded from path
+		void apply(fea::AnimatedQuad& quad, const std::string& path) const;
+
+		// frees the texture and forgets all images, has to be called
+		// before the OpenGL context is destroyed because the atlas
+		// instance lives longer than it
+		void release();
+};
+
+#endif // _TEXTURE_ATLAS_HPP_
@@ -0,0 +1,364 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Measures how fast incoming game messages are decoded into the typed
+ * structs the game works with (piece maps, movements, captures and
+ * promotions). The message stream is recorded from HeadlessMatch games
+ * of pseudo-random legal moves, starting from the opening arrays the
+ * game uses, and encoded once as JSON and once in the binary format.
+ *
+ * Three ways of decoding are timed:
+ * - JSON, the way CyvasseWSClient did it before: a new Json::Reader per
+ *   message, and a copy of the document for the message handler
+ * - JSON, the way it does it now: one Json::Reader for all messages,
+ *   parsing straight from the character range
+ * - binary, which decodes straight into the structs without a DOM
+ *
+ * Usage: msg_decode_bench [--white <file>] [--black <file>] [repetitions]
+ *
+ * Exits with status 1 if the JSON and the binary decoding of a message
+ * don't give the same result.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <json/reader.h>
+#include <json/writer.h>
+#include <cyvws/common.hpp>
+#include <cyvws/json_game_msg.hpp>
+#include "binary_game_msg.hpp"
+#include "mikelepage/headless_match.hpp"
+
+using namespace std;
+using namespace cyvmath;
+using namespace cyvmath::mikelepage;
+using namespace cyvws;
+
+using gamemsg::Action;
+using ::mikelepage::HeadlessMatch;
+
+struct Message
+{
+	Action action;
+	string json;
+	string binary;
+};
+
+static PieceMap loadPieceMap(const string& filePath)
+{
+	ifstream ifs(filePath);
+	if(!ifs)
+		throw runtime_error("Couldn't open \"" + filePath + "\"!");
+
+	Json::Value val;
+	if(!Json::Reader().parse(ifs, val, false))
+		throw runtime_error("Couldn't parse \"" + filePath + "\"!");
+
+	return json::pieceMap(val);
+}
+
+class StreamRecorder
+{
+	private:
+		unique_ptr<Json::StreamWriter> m_jsonWriter;
+		minstd_rand m_random;
+
+		vector<Message> m_messages;
+
+		void add(Action action, const Json::Value& json, string binary)
+		{
+			ostringstream jsonStream;
+			m_jsonWriter->write(json, &jsonStream);
+
+			m_messages.push_back({action, jsonStream.str(), move(binary)});
+		}
+
+		void addOpeningArray(HeadlessMatch& match, PlayersColor color)
+		{
+			ActivePieceMap pieces;
+
+			for(const auto& it : match.getActivePieces())
+			{
+				if(it.second->getColor() == color)
+					pieces.insert(it);
+			}
+
+			add(Action::SET_OPENING_ARRAY, json::gameMsgSetOpeningArray(pieces), binary::gameMsgSetOpeningArray(pieces));
+		}
+
+	public:
+		StreamRecorder()
+			// fixed seed, so every run decodes the same messages
+			: m_random(1)
+		{
+			Json::StreamWriterBuilder builder;
+			builder["indentation"] = "";
+
+			m_jsonWriter.reset(builder.newStreamWriter());
+		}
+
+		// plays one match with random moves, until it ends or maxMoves were done
+		void recordMatch(const PieceMap& white, const PieceMap& black, unsigned maxMoves)
+		{
+			HeadlessMatch match;
+
+			match.choosePromotion = [&](const set<PieceType>& types) {
+				auto it = types.begin();
+				advance(it, m_random() % types.size());
+
+				add(Action::PROMOTE, json::gameMsgPromote(PieceType::RABBLE, *it),
+					binary::gameMsgPromote(PieceType::RABBLE, *it));
+
+				return *it;
+			};
+
+			match.setOpeningArray(PlayersColor::WHITE, white);
+			match.setOpeningArray(PlayersColor::BLACK, black);
+
+			addOpeningArray(match, PlayersColor::WHITE);
+			addOpeningArray(match, PlayersColor::BLACK);
+
+			HeadlessMatch::MoveVec moves;
+
+			for(unsigned i = 0; i < maxMoves && !match.gameEnded(); i++)
+			{
+				moves.clear();
+				match.getLegalMoves(moves);
+
+				if(moves.empty())
+					break;
+
+				const auto& move = moves[m_random() % moves.size()];
+
+				auto piece = match.getPieceAt(move.from);
+				auto target = match.getPieceAt(move.to);
+
+				// the move message has to come before the promotion it causes
+				if(target)
+				{
+					add(Action::MOVE_CAPTURE,
+						json::gameMsgMoveCapture(piece->getType(), move.from, move.to, target->getType(), move.to),
+						binary::gameMsgMoveCapture(piece->getType(), move.from, move.to, target->getType(), move.to));
+				}
+				else
+				{
+					add(Action::MOVE,
+						json::gameMsgMove(piece->getType(), move.from, move.to),
+						binary::gameMsgMove(piece->getType(), move.from, move.to));
+				}
+
+				if(!match.doMove(move))
+					throw runtime_error("a generated move was rejected by the rules");
+			}
+		}
+
+		const vector<Message>& getMessages() const
+		{ return m_messages; }
+};
+
+// a hash of the decoded values, the same for equal results of the
+// JSON and the binary decoding. Also keeps the compiler from
+// optimizing the decoding away.
+static uint64_t checksum(Coordinate coord)
+{
+	return static_cast<uint64_t>(coord.x()) * 11 + static_cast<uint64_t>(coord.y());
+}
+
+static uint64_t checksum(PieceType type)
+{
+	return static_cast<uint64_t>(type);
+}
+
+static uint64_t checksum(const PieceMap& pieceMap)
+{
+	uint64_t ret = 0;
+
+	// the order of the coordinates of one type doesn't matter
+	for(const auto& it : pieceMap)
+		for(const auto& coord : it.second)
+			ret += (checksum(it.first) * 128 + checksum(coord)) * 2654435761u;
+
+	return ret;
+}
+
+static uint64_t checksum(const Movement& movement)
+{
+	return (checksum(movement.pieceType) * 128 + checksum(movement.oldPos)) * 128 + checksum(movement.newPos);
+}
+
+static uint64_t checksum(const MoveCapture& moveCapture)
+{
+	return (((checksum(moveCapture.atkPT) * 128 + checksum(moveCapture.oldPos)) * 128 + checksum(moveCapture.newPos))
+		* 16 + checksum(moveCapture.defPT)) * 128 + checksum(moveCapture.defPiecePos);
+}
+
+static uint64_t checksum(const Promotion& promotion)
+{
+	return checksum(promotion.origType) * 16 + checksum(promotion.newType);
+}
+
+// the parameters of the message, decoded by cyvws::json
+static uint64_t decodeJson(Action action, const Json::Value& param)
+{
+	switch(action)
+	{
+		case Action::SET_OPENING_ARRAY: return checksum(json::pieceMap(param));
+		case Action::MOVE:              return checksum(json::movement(param));
+		case Action::MOVE_CAPTURE:      return checksum(json::moveCapture(param));
+		case Action::PROMOTE:           return checksum(json::promotion(param));
+		default:                        return 0;
+	}
+}
+
+static uint64_t decodeBinary(Action action, const string& msg)
+{
+	switch(action)
+	{
+		case Action::SET_OPENING_ARRAY: return checksum(binary::pieceMap(msg));
+		case Action::MOVE:              return checksum(binary::movement(msg));
+		case Action::MOVE_CAPTURE:      return checksum(binary::moveCapture(msg));
+		case Action::PROMOTE:           return checksum(binary::promotion(msg));
+		default:                        return 0;
+	}
+}
+
+static uint64_t decodeJsonPerMessageReader(const Message& msg)
+{
+	Json::Reader reader;
+	Json::Value val;
+
+	if(!reader.parse(msg.json, val, false))
+		throw runtime_error("couldn't parse \"" + msg.json + "\"");
+
+	// the message handler took the document by value
+	Json::Value copy = val;
+	return decodeJson(msg.action, copy[MSG_DATA][PARAM]);
+}
+
+static uint64_t decodeJsonSharedReader(Json::Reader& reader, Json::Value& val, const Message& msg)
+{
+	const char* data = msg.json.data();
+
+	if(!reader.parse(data, data + msg.json.size(), val, false))
+		throw runtime_error("couldn't parse \"" + msg.json + "\"");
+
+	const Json::Value& constVal = val;
+	return decodeJson(msg.action, constVal[MSG_DATA][PARAM]);
+}
+
+template<class Func>
+static void run(const char* name, const vector<Message>& messages, unsigned repetitions, Func func)
+{
+	uint64_t sum = 0;
+	size_t bytes = 0;
+
+	auto begin = chrono::steady_clock::now();
+
+	for(unsigned i = 0; i < repetitions; i++)
+		for(const auto& msg : messages)
+			sum += func(msg, bytes);
+
+	auto end = chrono::steady_clock::now();
+
+	double seconds = chrono::duration<double>(end - begin).count();
+	double count = static_cast<double>(messages.size()) * repetitions;
+
+	cout << name << ": " << seconds * 1e9 / count << " ns per message, "
+	     << static_cast<uint64_t>(count / seconds) << " messages/s, "
+	     << bytes / repetitions << " bytes per pass (checksum " << sum << ")\n";
+}
+
+int main(int argc, char** argv)
+{
+	string whiteFile = "data/start-positions/white.json";
+	string blackFile = "data/start-positions/black.json";
+
+	int nextArg = 1;
+	for(; nextArg + 1 < argc; nextArg += 2)
+	{
+		string arg = argv[nextArg];
+
+		if(arg == "--white")
+			whiteFile = argv[nextArg + 1];
+		else if(arg == "--black")
+			blackFile = argv[nextArg + 1];
+		else
+			break;
+	}
+
+	try
+	{
+		unsigned repetitions = nextArg < argc ? stoul(argv[nextArg]) : 100;
+
+		PieceMap white = loadPieceMap(whiteFile);
+		PieceMap black = loadPieceMap(blackFile);
+
+		StreamRecorder recorder;
+		for(int i = 0; i < 20; i++)
+			recorder.recordMatch(white, black, 200);
+
+		const auto& messages = recorder.getMessages();
+
+		Json::Reader reader;
+		Json::Value val;
+
+		for(size_t i = 0; i < messages.size(); i++)
+		{
+			const auto& msg = messages[i];
+
+			if(decodeJsonSharedReader(reader, val, msg) != decodeBinary(msg.action, msg.binary))
+			{
+				cout << "message " << i << " is decoded differently from JSON and binary: " << msg.json << '\n';
+				return 1;
+			}
+		}
+
+		cout << messages.size() << " messages\n";
+
+		run("json, reader per message", messages, repetitions, [&](const Message& msg, size_t& bytes) {
+			bytes += msg.json.size();
+			return decodeJsonPerMessageReader(msg);
+		});
+
+		run("json, shared reader     ", messages, repetitions, [&](const Message& msg, size_t& bytes) {
+			bytes += msg.json.size();
+			return decodeJsonSharedReader(reader, val, msg);
+		});
+
+		run("binary                  ", messages, repetitions, [&](const Message& msg, size_t& bytes) {
+			bytes += msg.binary.size();
+			return decodeBinary(msg.action, msg.binary);
+		});
+
+		return 0;
+	}
+	catch(std::exception& e)
+	{
+		cerr << e.what() << endl;
+		return 2;
+	}
+}
@@ -0,0 +1,277 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Counts all move sequences of the Mikelepage rules up to a given
+ * depth, starting from two opening arrays (by default the ones the
+ * game uses). A promotion with a choice of piece types counts as one
+ * node per type. The node counts serve as a reference for any change
+ * to the move generation, see perft_check.sh.
+ *
+ * HeadlessMatch can't undo moves, so the position of every inner node
+ * is saved with getPosition() and restored with setPosition() before
+ * each of its moves. Only getLegalMoves() and doMove() are timed, the
+ * nodes/s are based on that time.
+ *
+ * Usage: perft [--white <file>] [--black <file>] <depth> [expected counts...]
+ *
+ * If expected counts are given (one per depth, starting at depth 1),
+ * the exit status tells whether all of them matched.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <json/reader.h>
+#include <cyvws/json_game_msg.hpp>
+#include "mikelepage/headless_match.hpp"
+
+using namespace std;
+using namespace cyvmath;
+using namespace cyvws;
+
+using ::mikelepage::BitboardPosition;
+using ::mikelepage::HeadlessMatch;
+
+typedef cyvmath::mikelepage::PieceMap PieceMap;
+
+struct StartPosition
+{
+	PieceMap white;
+	PieceMap black;
+};
+
+static PieceMap loadPieceMap(const string& filePath)
+{
+	ifstream ifs(filePath);
+	if(!ifs)
+		throw runtime_error("Couldn't open \"" + filePath + "\"!");
+
+	Json::Value val;
+	if(!Json::Reader().parse(ifs, val, false))
+		throw runtime_error("Couldn't parse \"" + filePath + "\"!");
+
+	return json::pieceMap(val);
+}
+
+// whether the player moving next could get a choice of promotions
+// by the next move, which is only possible for a rabble on its fortress
+static bool promotionChoicePossible(const BitboardPosition& position)
+{
+	PlayersColor next = !position.getActivePlayer();
+
+	return (position.pieces(next, PieceType::RABBLE) & position.fortress(next)).any();
+}
+
+class Perft
+{
+	private:
+		typedef chrono::steady_clock Clock;
+
+		HeadlessMatch m_match;
+
+		// the piece types offered by the promotion after the last move,
+		// empty if there was no choice
+		set<PieceType> m_choices;
+		// chosen if the next move leads to a promotion with a choice,
+		// UNDEFINED to take the first one
+		PieceType m_promotion;
+
+		// one vector per depth, so their memory is reused
+		vector<HeadlessMatch::MoveVec> m_moves;
+
+		// time spent in getLegalMoves() and doMove()
+		Clock::duration m_moveTime;
+
+		void getLegalMoves(HeadlessMatch::MoveVec& moves)
+		{
+			auto begin = Clock::now();
+			m_match.getLegalMoves(moves);
+			m_moveTime += Clock::now() - begin;
+		}
+
+		void doMove(const HeadlessMatch::Move& move, PieceType promotion)
+		{
+			m_choices.clear();
+			m_promotion = promotion;
+
+			auto begin = Clock::now();
+			bool valid = m_match.doMove(move);
+			m_moveTime += Clock::now() - begin;
+
+			if(!valid)
+				throw runtime_error("a generated move was rejected by the rules");
+		}
+
+		// counts the nodes below the current position of m_match
+		uint64_t count(unsigned depth)
+		{
+			if(depth == 0)
+				return 1;
+
+			auto& moves = m_moves[depth];
+			moves.clear();
+			getLegalMoves(moves);
+
+			BitboardPosition position = m_match.getPosition();
+
+			// the leaves only have to be visited
+			// if one of them can be more than one node
+			if(depth == 1 && !promotionChoicePossible(position))
+				return moves.size();
+
+			uint64_t nodes = 0;
+
+			for(const auto& move : moves)
+			{
+				m_match.setPosition(position);
+				doMove(move, PieceType::UNDEFINED);
+
+				if(m_choices.empty())
+				{
+					nodes += count(depth - 1);
+					continue;
+				}
+
+				// every piece type the move allows a promotion to leads
+				// to another node, the first one was already chosen
+				auto choices = m_choices;
+
+				for(auto it = choices.begin(); it != choices.end(); ++it)
+				{
+					if(it != choices.begin())
+					{
+						m_match.setPosition(position);
+						doMove(move, *it);
+					}
+
+					nodes += count(depth - 1);
+				}
+			}
+
+			return nodes;
+		}
+
+	public:
+		Perft(const StartPosition& start)
+			: m_promotion(PieceType::UNDEFINED)
+		{
+			m_match.choosePromotion = [this](const set<PieceType>& types) {
+				m_choices = types;
+				return m_promotion != PieceType::UNDEFINED ? m_promotion : *types.begin();
+			};
+
+			m_match.setOpeningArray(PlayersColor::WHITE, start.white);
+			m_match.setOpeningArray(PlayersColor::BLACK, start.black);
+		}
+
+		uint64_t run(unsigned depth)
+		{
+			m_moveTime = Clock::duration::zero();
+
+			if(depth == 0)
+				return 1;
+
+			BitboardPosition start = m_match.getPosition();
+			m_moves.resize(depth + 1);
+
+			uint64_t nodes = count(depth);
+
+			m_match.setPosition(start);
+			return nodes;
+		}
+
+		// the time run() spent in getLegalMoves() and doMove()
+		double moveSeconds() const
+		{
+			return chrono::duration<double>(m_moveTime).count();
+		}
+};
+
+int main(int argc, char** argv)
+{
+	string whiteFile = "data/start-positions/white.json";
+	string blackFile = "data/start-positions/black.json";
+
+	int nextArg = 1;
+	for(; nextArg + 1 < argc; nextArg += 2)
+	{
+		string arg = argv[nextArg];
+
+		if(arg == "--white")
+			whiteFile = argv[nextArg + 1];
+		else if(arg == "--black")
+			blackFile = argv[nextArg + 1];
+		else
+			break;
+	}
+
+	if(nextArg >= argc)
+	{
+		cerr << "Usage: " << argv[0] << " [--white <file>] [--black <file>] <depth> [expected counts...]\n";
+		return 2;
+	}
+
+	try
+	{
+		unsigned maxDepth = stoul(argv[nextArg]);
+
+		vector<uint64_t> expected;
+		for(int i = nextArg + 1; i < argc; i++)
+			expected.push_back(stoull(argv[i]));
+
+		StartPosition start{loadPieceMap(whiteFile), loadPieceMap(blackFile)};
+
+		Perft perft(start);
+		bool success = true;
+
+		for(unsigned depth = 1; depth <= maxDepth; depth++)
+		{
+			auto begin = chrono::steady_clock::now();
+			uint64_t nodes = perft.run(depth);
+			auto end = chrono::steady_clock::now();
+
+			double seconds = chrono::duration<double>(end - begin).count();
+			double moveSeconds = perft.moveSeconds();
+
+			cout << "depth " << depth << ": " << nodes << " nodes, "
+			     << seconds * 1000 << " ms, of that "
+			     << moveSeconds * 1000 << " ms generating and doing moves, "
+			     << static_cast<uint64_t>(moveSeconds > 0 ? nodes / moveSeconds : 0) << " nodes/s";
+
+			if(depth <= expected.size() && nodes != expected[depth - 1])
+			{
+				cout << " (expected " << expected[depth - 1] << ")";
+				success = false;
+			}
+
+			cout << '\n';
+		}
+
+		return success ? 0 : 1;
+	}
+	catch(std::exception& e)
+	{
+		cerr << e.what() << endl;
+		return 2;
+	}
+}
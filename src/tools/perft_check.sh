@@ -0,0 +1,26 @@
+#!/bin/sh
+# Runs perft from the opening arrays the game uses and compares its node
+# counts to the ones recorded in perft_counts.txt, so that any change to
+# the move generation that changes its results is noticed by make check.
+#
+# The counts have to come from a build that is known to follow the rules.
+# After an intended change of the rules, record them again with
+#   ./perft 3
+# and put the node count of every depth on its own line.
+#
+# Without recorded counts, perft still runs to depth 2, which fails if
+# the rules reject a move that getLegalMoves() generated.
+
+counts=`grep -v '^#' "$srcdir/src/tools/perft_counts.txt"`
+
+if test -z "$counts"; then
+	echo "no reference counts in perft_counts.txt, only checking the moves to depth 2"
+	depth=2
+else
+	depth=`echo $counts | wc -w`
+fi
+
+exec ./perft \
+	--white "$srcdir/data/start-positions/white.json" \
+	--black "$srcdir/data/start-positions/black.json" \
+	$depth $counts
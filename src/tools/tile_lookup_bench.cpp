@@ -0,0 +1,246 @@
+/* Copyright 2015 Jonas Platte
+ *
+ * This file is part of Cyvasse Online.
+ *
+ * Cyvasse Online is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * Cyvasse Online is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+ * PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Compares HexagonBoard::tileAt(), which maps mouse positions to tiles,
+ * with the separate per-orientation formulas that were used before it.
+ * For every pixel of an 800x600 window, both results are first checked
+ * against the tile rectangles calcTilePosition() places on the screen,
+ * then both lookups are run repeatedly for timing.
+ *
+ * Usage: tile_lookup_bench [repetitions]
+ *
+ * Exits with status 1 after printing the first pixel where tileAt()
+ * doesn't find the tile that is drawn there. The old formulas are off by
+ * one pixel at some tile edges (they assign the top edge of a row to the
+ * row above, and ignore the rounded board width when upside down), so the
+ * pixels where they are wrong are only counted.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "hexagon_board.hpp"
+
+using namespace std;
+
+typedef HexagonBoard<6> Board;
+typedef Board::Coordinate Coordinate;
+
+static const int l = 6;
+
+// the old HexagonBoard::getCoordinate(), with the board members as parameters
+static optional<Coordinate> oldGetCoordinate(glm::uvec2 mousePos, glm::uvec2 position, glm::vec2 tileSize, bool upsideDown)
+{
+	glm::uvec2 tilePos = mousePos - position;
+
+	float x, y;
+
+	if(!upsideDown)
+	{
+		y = (l * 2 - 1)
+			- tilePos.y / tileSize.y;
+
+		x = (
+				tilePos.x
+				+ ((l - static_cast<int>(y)) * tileSize.x / 2.0f)
+				- tileSize.x / 2.0f
+			)
+			/ tileSize.x;
+	}
+	else
+	{
+		y = tilePos.y / tileSize.y;
+
+		x = (l * 2 - 1)
+			- ((
+					tilePos.x
+					- ((l - static_cast<int>(y)) * tileSize.x / 2.0f)
+					+ tileSize.x / 2.0f
+				)
+				/ tileSize.x
+			);
+	}
+
+	if(x < 0.0f || y < 0.0f)
+		return nullopt;
+
+	return Coordinate::create(static_cast<int>(x), static_cast<int>(y));
+}
+
+struct Layout
+{
+	glm::uvec2 position;
+	glm::uvec2 boardSize;
+	glm::vec2 tileSize;
+	bool upsideDown;
+};
+
+// HexagonBoard::calcTilePosition(), with the board members as parameters
+static glm::vec2 tilePosition(Coordinate c, const Layout& layout)
+{
+	const glm::vec2& tileSize = layout.tileSize;
+	glm::vec2 ret;
+
+	if(!layout.upsideDown)
+	{
+		ret.x = layout.position.x + tileSize.x * c.x() + (tileSize.x / 2.0f) * (c.y() - (l - 1));
+		ret.y = layout.position.y + (layout.boardSize.y - (tileSize.y * c.y())) - tileSize.y;
+	}
+	else
+	{
+		ret.x = layout.position.x + (layout.boardSize.x - (tileSize.x * c.x())) - tileSize.x
+			- (tileSize.x / 2.0f) * (c.y() - (l - 1));
+		ret.y = layout.position.y + tileSize.y * c.y();
+	}
+
+	return ret;
+}
+
+// the tile whose rectangle contains the given pixel
+static optional<Coordinate> drawnTileAt(glm::vec2 pixel, const Layout& layout)
+{
+	for(int y = 0; y < l * 2 - 1; y++)
+	{
+		for(int x = 0; x < l * 2 - 1; x++)
+		{
+			auto coord = Coordinate::create(x, y);
+			if(!coord)
+				continue;
+
+			glm::vec2 tilePos = tilePosition(*coord, layout);
+
+			if(pixel.x >= tilePos.x && pixel.x < tilePos.x + layout.tileSize.x &&
+			   pixel.y >= tilePos.y && pixel.y < tilePos.y + layout.tileSize.y)
+				return coord;
+		}
+	}
+
+	return nullopt;
+}
+
+// whether the pixel lies on an edge of the tile's rectangle, give or take
+// float rounding; which tile such a pixel belongs to depends on the order
+// of the floating point operations, not on the lookup being right or wrong
+static bool onEdge(glm::vec2 pixel, const optional<Coordinate>& coord, const Layout& layout)
+{
+	if(!coord)
+		return false;
+
+	const float epsilon = 1.0f / 1024;
+
+	glm::vec2 tilePos = tilePosition(*coord, layout);
+	glm::vec2 tileEnd = tilePos + layout.tileSize;
+
+	return std::abs(pixel.x - tilePos.x) < epsilon || std::abs(pixel.x - tileEnd.x) < epsilon
+		|| std::abs(pixel.y - tilePos.y) < epsilon || std::abs(pixel.y - tileEnd.y) < epsilon;
+}
+
+static bool equal(const optional<Coordinate>& a, const optional<Coordinate>& b)
+{
+	return static_cast<bool>(a) == static_cast<bool>(b) && (!a || *a == *b);
+}
+
+static string toString(const optional<Coordinate>& coord)
+{
+	if(!coord)
+		return "none";
+
+	return "(" + to_string(coord->x()) + ", " + to_string(coord->y()) + ")";
+}
+
+template<class Func>
+static double run(unsigned repetitions, Func func, uint64_t& hits)
+{
+	hits = 0;
+
+	auto begin = chrono::steady_clock::now();
+
+	for(unsigned i = 0; i < repetitions; i++)
+		for(unsigned y = 0; y < 600; y++)
+			for(unsigned x = 0; x < 800; x++)
+				if(func(x, y))
+					hits++;
+
+	auto end = chrono::steady_clock::now();
+
+	return chrono::duration<double, nano>(end - begin).count() / (repetitions * 800.0 * 600.0);
+}
+
+int main(int argc, char** argv)
+{
+	unsigned repetitions = argc > 1 ? stoul(argv[1]) : 20;
+
+	// the layout HexagonBoard::updateLayout() calculates for 800x600
+	const glm::vec2 tileSize(570.0f / (l * 2 - 1) / 3.0f * 4.0f, 570.0f / (l * 2 - 1));
+	const glm::uvec2 boardSize(tileSize.x * (l * 2 - 1), 570);
+	const glm::uvec2 position((800 - boardSize.x) / 2, 15);
+	const glm::vec2 invTileSize(1.0f / tileSize.x, 1.0f / tileSize.y);
+
+	for(bool upsideDown : {false, true})
+	{
+		const Layout layout {position, boardSize, tileSize, upsideDown};
+
+		auto oldLookup = [&](unsigned x, unsigned y) {
+			return oldGetCoordinate({x, y}, position, tileSize, upsideDown);
+		};
+
+		auto newLookup = [&](unsigned x, unsigned y) {
+			glm::vec2 pos = glm::vec2(x, y) - glm::vec2(position);
+			return Board::tileAt(pos, glm::vec2(boardSize), invTileSize, upsideDown);
+		};
+
+		uint64_t oldMismatches = 0;
+
+		for(unsigned y = 0; y < 600; y++)
+			for(unsigned x = 0; x < 800; x++)
+			{
+				glm::vec2 pixel(x, y);
+
+				auto drawn = drawnTileAt(pixel, layout);
+				auto newCoord = newLookup(x, y);
+
+				if(!equal(newCoord, drawn) && !onEdge(pixel, drawn, layout) && !onEdge(pixel, newCoord, layout))
+				{
+					cout << (upsideDown ? "upside down" : "normal") << ": mismatch at pixel ("
+					     << x << ", " << y << "), drawn " << toString(drawn) << ", tileAt() " << toString(newCoord) << '\n';
+					return 1;
+				}
+
+				if(!equal(oldLookup(x, y), drawn))
+					oldMismatches++;
+			}
+
+		uint64_t oldHits, newHits;
+
+		double oldTime = run(repetitions, [&](unsigned x, unsigned y) {
+			return static_cast<bool>(oldLookup(x, y));
+		}, oldHits);
+
+		double newTime = run(repetitions, [&](unsigned x, unsigned y) {
+			return static_cast<bool>(newLookup(x, y));
+		}, newHits);
+
+		cout << (upsideDown ? "upside down" : "normal") << ":\n"
+		     << "  old: " << oldTime << " ns per lookup, " << oldHits / repetitions << " positions on the board, "
+		     << oldMismatches << " outside the drawn tile\n"
+		     << "  new: " << newTime << " ns per lookup, " << newHits / repetitions << " positions on the board\n";
+	}
+
+	return 0;
+}
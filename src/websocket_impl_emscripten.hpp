@@ -14,31 +14,216 @@
  * If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cstdint>
+#include <cstring>
 #include <emscripten.h>
 
+/* Incoming messages are written into this ring buffer in the heap by
+ * JavaScript and processed by poll(), so there is no call from JS into
+ * the game per message and no extra copy of the message data.
+ *
+ * Every record consists of the message size, its kind (text or binary),
+ * the message data and at least one padding byte, which is used for the
+ * NUL terminator written by stringToUTF8(). Records are 4-byte aligned
+ * and never wrap around; if a record doesn't fit at the end anymore, a
+ * wrap marker is written instead and the record is written at offset 0.
+ */
+struct WebsocketInbox
+{
+	static const uint32_t capacity   = 64 * 1024;
+	static const uint32_t wrapMarker = 0xFFFFFFFF;
+
+	enum Kind : uint32_t
+	{
+		TEXT,
+		BINARY
+	};
+
+	uint32_t readPos;  // only written by C++
+	uint32_t writePos; // only written by JS
+	char data[capacity];
+
+	static uint32_t recordSize(uint32_t msgSize)
+	{ return 8 + ((msgSize + 4) & ~3u); }
+};
+
+static WebsocketInbox s_inbox;
+
 class WebsocketImpl
 {
 	public:
 		WebsocketImpl();
 
-		void send(const std::string& msgData);
+		// the connection is managed by the surrounding web page
+		void connect(const std::string&)
+		{ }
+
+		void poll();
+
+		void send(const char* data, std::size_t size);
+		void sendBinary(const char* data, std::size_t size);
 };
 
 WebsocketImpl::WebsocketImpl()
 {
+	s_inbox.readPos = 0;
+	s_inbox.writePos = 0;
+
+	// handleMessageIngame / handleBinaryMessageIngame are called by the page
+	// for every incoming message. If the inbox is full, it is drained first.
+	// Messages that don't fit into the inbox at all take the slow path.
+	// handleReconnectIngame has to be called after the page reconnected.
 	EM_ASM(
-		wsClient.handleMessageIngame = Module.cwrap('game_handlemessage', undefined, ['string']);
+		var inbox = Module._game_inbox();
+		var capacity = Module._game_inbox_capacity();
+		var data = inbox + 8;
+
+		var recordSize = function(size) {
+			return 8 + ((size + 4) & ~3);
+		};
+
+		var reserve = function(size) {
+			var needed = recordSize(size);
+			var readPos = Module.HEAPU32[inbox >> 2];
+			var writePos = Module.HEAPU32[(inbox >> 2) + 1];
+
+			if (writePos >= readPos) {
+				if (writePos + needed <= capacity - 4)
+					return writePos;
+				if (needed >= readPos)
+					return -1;
+
+				Module.HEAPU32[(data + writePos) >> 2] = 0xFFFFFFFF;
+				return 0;
+			}
+
+			return (writePos + needed < readPos) ? writePos : -1;
+		};
+
+		var reserveOrDrain = function(size) {
+			var pos = reserve(size);
+			if (pos < 0) {
+				Module._game_drain_inbox();
+				pos = reserve(size);
+			}
+			return pos;
+		};
+
+		var commit = function(pos, kind, size) {
+			Module.HEAPU32[(data + pos) >> 2] = size;
+			Module.HEAPU32[((data + pos) >> 2) + 1] = kind;
+			Module.HEAPU32[(inbox >> 2) + 1] = pos + recordSize(size);
+		};
+
+		var handleMessageSlow = Module.cwrap('game_handlemessage', undefined, ['string']);
+
+		wsClient.handleReconnectIngame = Module.cwrap('game_reconnected', undefined, []);
+
+		wsClient.handleMessageIngame = function(str) {
+			var size = lengthBytesUTF8(str);
+			var pos = reserveOrDrain(size);
+			if (pos < 0) {
+				handleMessageSlow(str);
+				return;
+			}
+
+			stringToUTF8(str, data + pos + 8, size + 1);
+			commit(pos, 0, size);
+		};
+
+		wsClient.handleBinaryMessageIngame = function(buffer) {
+			var bytes = new Uint8Array(buffer);
+			var pos = reserveOrDrain(bytes.length);
+			if (pos < 0) {
+				var ptr = Module._malloc(bytes.length);
+				Module.HEAPU8.set(bytes, ptr);
+				Module._game_handlebinarymessage(ptr, bytes.length);
+				Module._free(ptr);
+				return;
+			}
+
+			Module.HEAPU8.set(bytes, data + pos + 8);
+			commit(pos, 1, bytes.length);
+		};
 	);
 }
 
-void WebsocketImpl::send(const std::string& msgData)
+void WebsocketImpl::poll()
 {
+	auto& client = CyvasseWSClient::instance();
+
+	while(s_inbox.readPos != s_inbox.writePos)
+	{
+		const char* record = s_inbox.data + s_inbox.readPos;
+
+		uint32_t size;
+		std::memcpy(&size, record, 4);
+
+		if(size == WebsocketInbox::wrapMarker)
+		{
+			s_inbox.readPos = 0;
+			continue;
+		}
+
+		uint32_t kind;
+		std::memcpy(&kind, record + 4, 4);
+
+		// the message is processed directly from the inbox
+		if(kind == WebsocketInbox::BINARY)
+			client.handleBinaryMessageWrap(record + 8, size);
+		else
+			client.handleMessageWrap(record + 8, size);
+
+		s_inbox.readPos += WebsocketInbox::recordSize(size);
+	}
+}
+
+void WebsocketImpl::send(const char* data, std::size_t size)
+{
+	// with the length given, the data doesn't have to be NUL-terminated
 	EM_ASM_({
-		wsClient.send(Module.Pointer_stringify($0));
-	}, msgData.c_str());
+		wsClient.send(Module.Pointer_stringify($0, $1));
+	}, data, size);
+}
+
+void WebsocketImpl::sendBinary(const char* data, std::size_t size)
+{
+	// the websocket copies the data, so a view of the heap is sufficient
+	EM_ASM_({
+		wsClient.send(Module.HEAPU8.subarray($0, $0 + $1));
+	}, data, size);
+}
+
+extern "C" WebsocketInbox* game_inbox()
+{
+	return &s_inbox;
+}
+
+extern "C" uint32_t game_inbox_capacity()
+{
+	return WebsocketInbox::capacity;
+}
+
+// processes all messages in the inbox at once
+extern "C" void game_drain_inbox()
+{
+	CyvasseWSClient::instance().poll();
 }
 
+extern "C" void game_reconnected()
+{
+	// process what arrived before the connection was lost first
+	CyvasseWSClient::instance().poll();
+	CyvasseWSClient::instance().onReconnected();
+}
+
+// used for messages that are too big for the inbox
 extern "C" void game_handlemessage(const char* msgData)
 {
-	CyvasseWSClient::instance().handleMessageWrap(std::string(msgData));
+	CyvasseWSClient::instance().handleMessageWrap(msgData, std::strlen(msgData));
+}
+
+extern "C" void game_handlebinarymessage(const char* data, size_t size)
+{
+	CyvasseWSClient::instance().handleBinaryMessageWrap(data, size);
 }
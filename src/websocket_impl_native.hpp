@@ -14,15 +14,234 @@
  * If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include "spsc_queue.hpp"
+
 #define _WEBSOCKETPP_CPP11_STL_
 #include <websocketpp/config/asio_no_tls_client.hpp>
 #include <websocketpp/client.hpp>
 #undef _WEBSOCKETPP_CPP11_STL
 
+using std::placeholders::_1;
+using std::placeholders::_2;
+
+/* All networking is done on a separate I/O thread running the asio
+ * event loop. Messages are exchanged with the game thread through
+ * two single-producer single-consumer queues, so neither thread
+ * ever has to wait for the other one.
+ *
+ * If the connection is lost, it is established again with increasing
+ * delays. The game thread is notified about that in the next poll().
+ */
 class WebsocketImpl
 {
-	// TODO
+	private:
+		typedef websocketpp::client<websocketpp::config::asio_client> Client;
+
+		// in milliseconds. These are only declared here, so they must
+		// not be bound to references (e.g. passed to std::min directly).
+		static constexpr long initialReconnectDelay = 500;
+		static constexpr long maxReconnectDelay = 16000;
+
+		Client m_client;
+		websocketpp::connection_hdl m_connection;
+		std::string m_uri;
+		std::thread m_ioThread;
+
+		// only accessed by the I/O thread
+		bool m_open;
+		bool m_wasOpen;
+		long m_reconnectDelay;
+
+		// set by the I/O thread, reset by poll()
+		std::atomic<bool> m_reconnected;
+
+		// frames are stored together with their opcode,
+		// to tell text (JSON) and binary messages apart
+		typedef std::pair<websocketpp::frame::opcode::value, std::string> Frame;
+
+		// I/O thread -> game thread
+		SPSCQueue<Frame> m_inbox;
+		// game thread -> I/O thread
+		SPSCQueue<Frame> m_outbox;
+
+		void onOpen(websocketpp::connection_hdl);
+		void onMessage(websocketpp::connection_hdl, Client::message_ptr);
+		void onClose(websocketpp::connection_hdl);
+
+		websocketpp::lib::error_code openConnection();
+		void scheduleReconnect();
+		void reconnect(const websocketpp::lib::error_code&);
+
+		// sends all queued messages, runs on the I/O thread
+		void flushOutbox();
+
 	public:
-		void send(const std::string& /* msgData */)
-		{ }
+		WebsocketImpl();
+		~WebsocketImpl();
+
+		WebsocketImpl(const WebsocketImpl&) = delete;
+		WebsocketImpl& operator=(const WebsocketImpl&) = delete;
+
+		void connect(const std::string& uri);
+		void poll();
+		// the data is copied into the queue for the I/O thread
+		void send(const char* data, std::size_t size);
+		void sendBinary(const char* data, std::size_t size);
 };
+
+WebsocketImpl::WebsocketImpl()
+	: m_open(false)
+	, m_wasOpen(false)
+	, m_reconnectDelay(initialReconnectDelay)
+	, m_reconnected(false)
+{
+	m_client.clear_access_channels(websocketpp::log::alevel::all);
+	m_client.init_asio();
+
+	m_client.set_open_handler(std::bind(&WebsocketImpl::onOpen, this, _1));
+	m_client.set_close_handler(std::bind(&WebsocketImpl::onClose, this, _1));
+	m_client.set_fail_handler(std::bind(&WebsocketImpl::onClose, this, _1));
+	m_client.set_message_handler(std::bind(&WebsocketImpl::onMessage, this, _1, _2));
+}
+
+WebsocketImpl::~WebsocketImpl()
+{
+	if(m_ioThread.joinable())
+	{
+		m_client.stop();
+		m_ioThread.join();
+	}
+}
+
+void WebsocketImpl::connect(const std::string& uri)
+{
+	if(m_ioThread.joinable())
+		throw std::runtime_error("Already connected to a server");
+
+	m_uri = uri;
+
+	auto ec = openConnection();
+	if(ec)
+		throw std::runtime_error("Could not connect to " + uri + ": " + ec.message());
+
+	// keep the event loop running while there is no connection
+	m_client.start_perpetual();
+	m_ioThread = std::thread([this] { m_client.run(); });
+}
+
+websocketpp::lib::error_code WebsocketImpl::openConnection()
+{
+	websocketpp::lib::error_code ec;
+	Client::connection_ptr con = m_client.get_connection(m_uri, ec);
+	if(ec)
+		return ec;
+
+	m_connection = con->get_handle();
+	m_client.connect(con);
+
+	return ec;
+}
+
+void WebsocketImpl::scheduleReconnect()
+{
+	m_client.set_timer(m_reconnectDelay, std::bind(&WebsocketImpl::reconnect, this, _1));
+	m_reconnectDelay = std::min<long>(m_reconnectDelay * 2, long(maxReconnectDelay));
+}
+
+void WebsocketImpl::reconnect(const websocketpp::lib::error_code& ec)
+{
+	// the timer was cancelled
+	if(ec)
+		return;
+
+	auto connectError = openConnection();
+	if(connectError)
+	{
+		std::cerr << "Reconnecting failed: " << connectError.message() << '\n';
+		scheduleReconnect();
+	}
+}
+
+void WebsocketImpl::onOpen(websocketpp::connection_hdl)
+{
+	m_open = true;
+	m_reconnectDelay = initialReconnectDelay;
+
+	if(m_wasOpen)
+		m_reconnected = true;
+
+	m_wasOpen = true;
+
+	// send everything that was queued while connecting
+	flushOutbox();
+}
+
+void WebsocketImpl::onMessage(websocketpp::connection_hdl, Client::message_ptr msg)
+{
+	m_inbox.push(Frame(msg->get_opcode(), msg->get_payload()));
+}
+
+void WebsocketImpl::onClose(websocketpp::connection_hdl)
+{
+	m_open = false;
+	scheduleReconnect();
+}
+
+void WebsocketImpl::flushOutbox()
+{
+	if(!m_open)
+		return;
+
+	Frame frame;
+	while(m_outbox.pop(frame))
+	{
+		websocketpp::lib::error_code ec;
+		m_client.send(m_connection, frame.second, frame.first, ec);
+		if(ec)
+			std::cerr << "Sending a message failed: " << ec.message() << '\n';
+	}
+}
+
+void WebsocketImpl::poll()
+{
+	if(m_reconnected.exchange(false))
+		CyvasseWSClient::instance().onReconnected();
+
+	Frame frame;
+	while(m_inbox.pop(frame))
+	{
+		if(frame.first == websocketpp::frame::opcode::binary)
+			CyvasseWSClient::instance().handleBinaryMessageWrap(frame.second);
+		else
+			CyvasseWSClient::instance().handleMessageWrap(frame.second);
+	}
+}
+
+void WebsocketImpl::send(const char* data, std::size_t size)
+{
+	// without connect(), the I/O thread doesn't run and
+	// nothing would ever be taken out of the outbox again
+	if(!m_ioThread.joinable())
+		return;
+
+	m_outbox.push(Frame(websocketpp::frame::opcode::text, std::string(data, size)));
+	// asio's post() is thread-safe, the flush itself runs on the I/O thread
+	m_client.get_io_service().post(std::bind(&WebsocketImpl::flushOutbox, this));
+}
+
+void WebsocketImpl::sendBinary(const char* data, std::size_t size)
+{
+	if(!m_ioThread.joinable())
+		return;
+
+	m_outbox.push(Frame(websocketpp::frame::opcode::binary, std::string(data, size)));
+	m_client.get_io_service().post(std::bind(&WebsocketImpl::flushOutbox, this));
+}